@@ -0,0 +1,131 @@
+/*! Times the Hash and SortedLog book-keeping backends of CRPSOutputArchive
+    on heap graphs with 0 to 32 pointers per node, and reports the backend
+    chosen by sampling for each density.
+
+    The nodes are allocated one by one between allocations of varying size,
+    so they are scattered like the nodes of a long-lived heap graph and are
+    indexed by the backend rather than coalesced into address runs. Each
+    pointer references a random node, drawn by bench/generators.hpp from the
+    direction argument. Save times are the best of the repeated runs, and are
+    written to stdout as tab separated columns, so the density from which the
+    Hash backend is faster can be compared with the sampling threshold.
+
+    Build and run:
+
+        g++ -std=c++11 -O2 -pthread -Iinclude -I<cereal>/include bench/backends.cpp -o backends
+        ./backends [size] [repeat] [backward|forward|mixed]
+*/
+
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/vector.hpp>
+#include <crps/crps.hpp>
+
+#include "generators.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+#include <string>
+
+namespace bench
+{
+    //! A node allocated on its own, referencing other nodes by CRPS raw pointers
+    struct HeapNode
+    {
+        std::uint32_t id;
+        std::vector<crps::raw_ptr<HeapNode>> refs;
+
+        template <class Archive>
+        void serialize(Archive& ar) { ar(id, refs); }
+    };
+
+    //! Nodes scattered over the heap, saved in allocation order
+    struct HeapGraph
+    {
+        std::vector<std::unique_ptr<HeapNode>> nodes{};
+
+        HeapGraph(WorkloadOptions const& options)
+        {
+            std::mt19937 random(options.seed);
+            std::vector<std::unique_ptr<char[]>> gaps{};
+            for (std::size_t i = 0; i < options.size; i++)
+            {
+                nodes.emplace_back(new HeapNode{ static_cast<std::uint32_t>(i), {} });
+                gaps.emplace_back(new char[16 + random() % 200]);
+            }
+            for (std::size_t i = 0; i < options.size; i++)
+            {
+                const std::size_t count = drawCount(options.density, random);
+                std::uint32_t target = 0;
+                for (std::size_t k = 0; k < count && drawTarget(i, options.size, options.direction, random, target); k++) {
+                    nodes[i]->refs.push_back(nodes[target].get());
+                }
+            }
+        }
+
+        template <class Archive>
+        void save(Archive& ar) const
+        {
+            for (std::unique_ptr<HeapNode> const& node : nodes) {
+                ar(*node);
+            }
+        }
+    };
+
+    //! Best time in milliseconds of repeat saves of graph with backend, and the stats of the last save
+    double timeSave(HeapGraph const& graph, crps::CRPSBackend backend, std::size_t repeat, crps::CRPSMapperStats& stats)
+    {
+        double best = 0.0;
+        for (std::size_t i = 0; i < repeat; i++)
+        {
+            std::ostringstream stream;
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            {
+                cereal::BinaryOutputArchive oarchive(stream);
+                crps::CRPSOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+                crps_oarchive.setBackend(backend);
+                graph.save(crps_oarchive);
+                stats = crps_oarchive.stats();
+                crps_oarchive.complete();
+            }
+            const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            best = i == 0 || elapsed < best ? elapsed : best;
+        }
+        return best;
+    }
+
+    const char* backendName(crps::CRPSBackend backend)
+    {
+        return backend == crps::CRPSBackend::Hash ? "hash" : backend == crps::CRPSBackend::SortedLog ? "sorted_log" : "automatic";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bench::WorkloadOptions options;
+    options.size = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    const std::size_t repeat = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 5;
+    if (argc > 3 && !bench::parseDirection(argv[3], options.direction))
+    {
+        std::fprintf(stderr, "usage: backends [size] [repeat] [backward|forward|mixed]\n");
+        return 1;
+    }
+
+    std::printf("density\tpointers_per_indexed_object\thash_ms\tsorted_log_ms\tautomatic_ms\tautomatic_backend\n");
+    const double densities[] = { 0.0, 0.5, 1.0, 2.0, 4.0, 8.0, 12.0, 16.0, 24.0, 32.0 };
+    for (double density : densities)
+    {
+        options.density = density;
+        const bench::HeapGraph graph(options);
+        crps::CRPSMapperStats stats{};
+        const double hash = bench::timeSave(graph, crps::CRPSBackend::Hash, repeat, stats);
+        const double sorted_log = bench::timeSave(graph, crps::CRPSBackend::SortedLog, repeat, stats);
+        const double automatic = bench::timeSave(graph, crps::CRPSBackend::Automatic, repeat, stats);
+        std::printf("%.2f\t%.2f\t%.1f\t%.1f\t%.1f\t%s\n", density,
+            stats.table_entries != 0 ? static_cast<double>(stats.pointers) / static_cast<double>(stats.table_entries) : 0.0,
+            hash, sorted_log, automatic, bench::backendName(stats.backend));
+    }
+    return 0;
+}
@@ -0,0 +1,605 @@
+/*! Compares saving and loading the same logical pointer graphs with
+    plain cereal and std::shared_ptr, with CRPS and raw pointers, and with
+    Boost.Serialization object tracking.
+
+    Every shape and variant runs in its own process, so peak RSS is reported
+    per variant. Save and load times are the best of the repeated runs, and
+    allocations are counted by a replaced global operator new. Results are
+    written to stdout as tab separated columns. The graphs are generated by
+    bench/generators.hpp from the size, density and direction arguments.
+
+    Build and run, on POSIX systems:
+
+        g++ -std=c++11 -O2 -pthread -Iinclude -I<cereal>/include bench/compare.cpp -lboost_serialization -o compare
+        ./compare [size] [repeat] [density] [backward|forward|mixed]
+*/
+
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/memory.hpp>
+#include <cereal/types/vector.hpp>
+#include <crps/crps.hpp>
+
+#include "generators.hpp"
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <sstream>
+#include <string>
+
+namespace
+{
+    std::atomic<std::size_t> allocation_count{ 0 }; //!< Calls of the global operator new
+}
+
+void* operator new(std::size_t size)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size != 0 ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+namespace bench
+{
+    // ######################################################################
+    //! Every referenced object is allocated by a std::shared_ptr, serialized by plain cereal
+    namespace shared
+    {
+        struct Vertex
+        {
+            std::uint32_t id;
+            float targetA;
+            float targetB;
+
+            template <class Archive>
+            void serialize(Archive& ar) { ar(id, targetA, targetB); }
+        };
+
+        struct Edge
+        {
+            std::shared_ptr<Vertex> vertex;
+            std::shared_ptr<Vertex> target; //!< A std::shared_ptr cannot reference a member, so the member is saved by index
+            std::uint8_t member;
+
+            template <class Archive>
+            void serialize(Archive& ar) { ar(vertex, target, member); }
+        };
+
+        struct Face
+        {
+            std::shared_ptr<Edge> first;
+            std::shared_ptr<Edge> second;
+            std::shared_ptr<Edge> third;
+
+            template <class Archive>
+            void serialize(Archive& ar) { ar(first, second, third); }
+        };
+
+        struct Mesh
+        {
+            std::vector<std::shared_ptr<Vertex>> vertices;
+            std::vector<std::shared_ptr<Edge>> edges;
+            std::vector<Face> faces;
+            std::uint8_t order{ 0 };
+
+            Mesh() = default;
+
+            explicit Mesh(MeshSpec const& spec) : order(static_cast<std::uint8_t>(spec.order))
+            {
+                for (std::size_t i = 0; i < spec.vertices; i++) {
+                    vertices.push_back(std::make_shared<Vertex>(Vertex{ static_cast<std::uint32_t>(i), float(i), float(i) + 0.5f }));
+                }
+                for (std::size_t i = 0; i < spec.from.size(); i++) {
+                    edges.push_back(std::make_shared<Edge>(Edge{ vertices[spec.from[i]], vertices[spec.to[i]], spec.member[i] }));
+                }
+                for (std::size_t i = 0; i < spec.faces(); i++) {
+                    faces.push_back(Face{ edges[3 * i], edges[3 * i + 1], edges[3 * i + 2] });
+                }
+            }
+
+            MeshSpec spec() const
+            {
+                MeshSpec result;
+                result.vertices = vertices.size();
+                result.order = static_cast<Direction>(order);
+                for (std::shared_ptr<Edge> const& edge : edges)
+                {
+                    result.from.push_back(edge->vertex->id);
+                    result.to.push_back(edge->target->id);
+                    result.member.push_back(edge->member);
+                }
+                for (std::size_t i = 0; i < faces.size(); i++)
+                {
+                    if (faces[i].first != edges[3 * i] || faces[i].second != edges[3 * i + 1] || faces[i].third != edges[3 * i + 2]) {
+                        result.vertices = 0;
+                    }
+                }
+                return result;
+            }
+
+            template <class Archive>
+            void serialize(Archive& ar)
+            {
+                ar(order);
+                switch (static_cast<Direction>(order))
+                {
+                case Direction::Backward:
+                    ar(vertices, edges, faces);
+                    break;
+                case Direction::Forward:
+                    ar(faces, edges, vertices);
+                    break;
+                case Direction::Mixed:
+                    ar(edges, vertices, faces);
+                    break;
+                }
+            }
+        };
+
+        struct Node
+        {
+            std::uint32_t id;
+            float x, y, z;
+            std::weak_ptr<Node> parent;
+            std::vector<std::shared_ptr<Node>> children;
+            std::vector<std::weak_ptr<Node>> refs;
+
+            template <class Archive>
+            void serialize(Archive& ar) { ar(id, x, y, z, parent, children, refs); }
+        };
+
+        struct Scene
+        {
+            std::shared_ptr<Node> root;
+
+            Scene() = default;
+
+            explicit Scene(SceneSpec const& spec)
+            {
+                std::vector<std::shared_ptr<Node>> nodes;
+                for (std::size_t i = 0; i < spec.parent.size(); i++) {
+                    nodes.push_back(std::make_shared<Node>(Node{ static_cast<std::uint32_t>(i), float(i), 0.0f, 0.0f, {}, {}, {} }));
+                }
+                for (std::size_t i = 0; i < nodes.size(); i++)
+                {
+                    if (i != 0) {
+                        nodes[i]->parent = nodes[spec.parent[i]];
+                        nodes[spec.parent[i]]->children.push_back(nodes[i]);
+                    }
+                    for (std::uint32_t ref : spec.refs[i]) {
+                        nodes[i]->refs.push_back(nodes[ref]);
+                    }
+                }
+                root = nodes.empty() ? nullptr : nodes[0];
+            }
+
+            SceneSpec spec() const
+            {
+                SceneSpec result;
+                std::vector<Node const*> stack{ root.get() };
+                while (!stack.empty() && stack.back() != nullptr)
+                {
+                    Node const* node = stack.back();
+                    stack.pop_back();
+                    if (result.parent.size() <= node->id) {
+                        result.parent.resize(node->id + 1);
+                        result.refs.resize(node->id + 1);
+                    }
+                    std::shared_ptr<Node> parent = node->parent.lock();
+                    result.parent[node->id] = parent ? parent->id : node->id;
+                    for (std::weak_ptr<Node> const& ref : node->refs) {
+                        result.refs[node->id].push_back(ref.lock()->id);
+                    }
+                    for (std::shared_ptr<Node> const& child : node->children)
+                    {
+                        if (child->parent.lock().get() != node) {
+                            result.parent.assign(1, std::numeric_limits<std::uint32_t>::max());
+                            return result;
+                        }
+                        stack.push_back(child.get());
+                    }
+                }
+                return result;
+            }
+
+            template <class Archive>
+            void serialize(Archive& ar) { ar(root); }
+        };
+    }
+
+    // ######################################################################
+    //! Objects are referenced by raw pointers and tracked by Boost.Serialization
+    namespace boost_tracked
+    {
+        //! Boost does not track pointers to primitive types, so targets are wrapped in a class
+        struct Target
+        {
+            float value;
+
+            template <class Archive>
+            void serialize(Archive& ar, const unsigned int) { ar & value; }
+        };
+
+        struct Vertex
+        {
+            std::uint32_t id;
+            Target targetA;
+            Target targetB;
+
+            template <class Archive>
+            void serialize(Archive& ar, const unsigned int) { ar & id & targetA & targetB; }
+        };
+
+        struct Edge
+        {
+            Vertex* vertex;
+            Target* target;
+
+            template <class Archive>
+            void serialize(Archive& ar, const unsigned int) { ar & vertex & target; }
+        };
+
+        struct Face
+        {
+            Edge* first;
+            Edge* second;
+            Edge* third;
+
+            template <class Archive>
+            void serialize(Archive& ar, const unsigned int) { ar & first & second & third; }
+        };
+
+        struct Mesh
+        {
+            std::vector<Vertex> vertices;
+            std::vector<Edge> edges;
+            std::vector<Face> faces;
+            std::uint8_t order{ 0 };
+
+            Mesh() = default;
+
+            explicit Mesh(MeshSpec const& spec) : order(static_cast<std::uint8_t>(spec.order))
+            {
+                for (std::size_t i = 0; i < spec.vertices; i++) {
+                    vertices.push_back(Vertex{ static_cast<std::uint32_t>(i), Target{ float(i) }, Target{ float(i) + 0.5f } });
+                }
+                for (std::size_t i = 0; i < spec.from.size(); i++)
+                {
+                    Vertex& target = vertices[spec.to[i]];
+                    edges.push_back(Edge{ &vertices[spec.from[i]], spec.member[i] ? &target.targetB : &target.targetA });
+                }
+                for (std::size_t i = 0; i < spec.faces(); i++) {
+                    faces.push_back(Face{ &edges[3 * i], &edges[3 * i + 1], &edges[3 * i + 2] });
+                }
+            }
+
+            MeshSpec spec() const
+            {
+                MeshSpec result;
+                result.vertices = vertices.size();
+                result.order = static_cast<Direction>(order);
+                for (Edge const& edge : edges)
+                {
+                    const std::uint32_t to = indexOf(edge.target, vertices.data());
+                    result.from.push_back(indexOf(edge.vertex, vertices.data()));
+                    result.to.push_back(to);
+                    result.member.push_back(edge.target == &vertices[to].targetB ? 1 : 0);
+                }
+                for (std::size_t i = 0; i < faces.size(); i++)
+                {
+                    if (faces[i].first != &edges[3 * i] || faces[i].second != &edges[3 * i + 1] || faces[i].third != &edges[3 * i + 2]) {
+                        result.vertices = 0;
+                    }
+                }
+                return result;
+            }
+
+            /*! Boost cannot load a pointer to an object that is serialized by value after
+                the pointer, so vertices, edges and faces are saved in Backward order for
+                every direction. */
+            template <class Archive>
+            void serialize(Archive& ar, const unsigned int) { ar & order & vertices & edges & faces; }
+        };
+
+        struct Node
+        {
+            std::uint32_t id;
+            float x, y, z;
+            Node* parent;
+            std::vector<Node*> children;
+            std::vector<Node*> refs;
+
+            template <class Archive>
+            void serialize(Archive& ar, const unsigned int) { ar & id & x & y & z & parent & children & refs; }
+        };
+
+        struct Scene
+        {
+            Node* root{ nullptr }; //!< Owns every node of the tree
+
+            Scene() = default;
+
+            explicit Scene(SceneSpec const& spec)
+            {
+                std::vector<Node*> nodes;
+                for (std::size_t i = 0; i < spec.parent.size(); i++) {
+                    nodes.push_back(new Node{ static_cast<std::uint32_t>(i), float(i), 0.0f, 0.0f, nullptr, {}, {} });
+                }
+                for (std::size_t i = 0; i < nodes.size(); i++)
+                {
+                    if (i != 0) {
+                        nodes[i]->parent = nodes[spec.parent[i]];
+                        nodes[spec.parent[i]]->children.push_back(nodes[i]);
+                    }
+                    for (std::uint32_t ref : spec.refs[i]) {
+                        nodes[i]->refs.push_back(nodes[ref]);
+                    }
+                }
+                root = nodes.empty() ? nullptr : nodes[0];
+            }
+
+            Scene(Scene const&) = delete;
+            Scene& operator=(Scene const&) = delete;
+
+            ~Scene()
+            {
+                std::vector<Node*> stack{ root };
+                while (!stack.empty() && stack.back() != nullptr)
+                {
+                    Node* node = stack.back();
+                    stack.pop_back();
+                    stack.insert(stack.end(), node->children.begin(), node->children.end());
+                    delete node;
+                }
+            }
+
+            SceneSpec spec() const
+            {
+                SceneSpec result;
+                std::vector<Node const*> stack{ root };
+                while (!stack.empty() && stack.back() != nullptr)
+                {
+                    Node const* node = stack.back();
+                    stack.pop_back();
+                    if (result.parent.size() <= node->id) {
+                        result.parent.resize(node->id + 1);
+                        result.refs.resize(node->id + 1);
+                    }
+                    result.parent[node->id] = node->parent ? node->parent->id : node->id;
+                    for (Node const* ref : node->refs) {
+                        result.refs[node->id].push_back(ref->id);
+                    }
+                    for (Node const* child : node->children)
+                    {
+                        if (child->parent != node) {
+                            result.parent.assign(1, std::numeric_limits<std::uint32_t>::max());
+                            return result;
+                        }
+                        stack.push_back(child);
+                    }
+                }
+                return result;
+            }
+
+            template <class Archive>
+            void serialize(Archive& ar, const unsigned int) { ar & root; }
+        };
+    }
+
+    // ######################################################################
+    //! Plain cereal binary archives
+    struct CerealFormat
+    {
+        template <class Graph>
+        static void save(std::ostream& stream, Graph const& graph)
+        {
+            cereal::BinaryOutputArchive oarchive(stream);
+            oarchive(graph);
+        }
+
+        template <class Graph>
+        static void load(std::istream& stream, Graph& graph)
+        {
+            cereal::BinaryInputArchive iarchive(stream);
+            iarchive(graph);
+        }
+    };
+
+    //! cereal binary archives wrapped by CRPS
+    struct CRPSFormat
+    {
+        template <class Graph>
+        static void save(std::ostream& stream, Graph const& graph)
+        {
+            cereal::BinaryOutputArchive oarchive(stream);
+            crps::CRPSOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+            crps_oarchive(graph);
+        }
+
+        template <class Graph>
+        static void load(std::istream& stream, Graph& graph)
+        {
+            cereal::BinaryInputArchive iarchive(stream);
+            crps::CRPSInputArchive<cereal::BinaryInputArchive> crps_iarchive(iarchive);
+            crps_iarchive(graph);
+        }
+    };
+
+    //! cereal binary archives wrapped by CRPS, with the crps mapper on a worker thread
+    struct CRPSConcurrentFormat : CRPSFormat
+    {
+        template <class Graph>
+        static void save(std::ostream& stream, Graph const& graph)
+        {
+            cereal::BinaryOutputArchive oarchive(stream);
+            crps::CRPSOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+            crps_oarchive.setConcurrentMapper(true);
+            crps_oarchive(graph);
+        }
+    };
+
+    //! Boost.Serialization binary archives
+    struct BoostFormat
+    {
+        template <class Graph>
+        static void save(std::ostream& stream, Graph const& graph)
+        {
+            boost::archive::binary_oarchive oarchive(stream);
+            oarchive << graph;
+        }
+
+        template <class Graph>
+        static void load(std::istream& stream, Graph& graph)
+        {
+            boost::archive::binary_iarchive iarchive(stream);
+            iarchive >> graph;
+        }
+    };
+
+    // ######################################################################
+    //! Measurements of one shape and variant
+    struct Result
+    {
+        double save_ms{ std::numeric_limits<double>::max() };
+        double load_ms{ std::numeric_limits<double>::max() };
+        std::size_t bytes{ 0 };
+        std::size_t save_allocations{ 0 };
+        std::size_t load_allocations{ 0 };
+        bool verified{ false };
+    };
+
+    inline double elapsedMs(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    //! Saves and loads the graph of spec repeat times, and verifies the loaded graph against spec
+    template <class Format, class Graph, class Spec>
+    Result measure(Spec const& spec, unsigned repeat)
+    {
+        Result result;
+        const Graph graph(spec);
+        std::string bytes;
+        for (unsigned i = 0; i < repeat; i++)
+        {
+            std::ostringstream stream;
+            const std::size_t allocations = allocation_count.load();
+            const auto start = std::chrono::steady_clock::now();
+            Format::save(stream, graph);
+            result.save_ms = std::min(result.save_ms, elapsedMs(start));
+            result.save_allocations = allocation_count.load() - allocations;
+            bytes = stream.str();
+        }
+        result.bytes = bytes.size();
+
+        for (unsigned i = 0; i < repeat; i++)
+        {
+            std::istringstream stream(bytes);
+            Graph loaded;
+            const std::size_t allocations = allocation_count.load();
+            const auto start = std::chrono::steady_clock::now();
+            Format::load(stream, loaded);
+            result.load_ms = std::min(result.load_ms, elapsedMs(start));
+            result.load_allocations = allocation_count.load() - allocations;
+            result.verified = loaded.spec() == spec;
+        }
+        return result;
+    }
+
+    //! A shape and variant, run in a process of its own
+    struct Case
+    {
+        const char* shape;
+        const char* variant;
+        Result (*run)(WorkloadOptions const& options, unsigned repeat);
+    };
+
+    template <class Format, class Graph, class Spec>
+    Result runCase(WorkloadOptions const& options, unsigned repeat)
+    {
+        return measure<Format, Graph>(Spec::generate(options), repeat);
+    }
+
+    const Case cases[] = {
+        { "mesh", "shared_ptr", &runCase<CerealFormat, shared::Mesh, MeshSpec> },
+        { "mesh", "crps", &runCase<CRPSFormat, raw::Mesh<>, MeshSpec> },
+        { "mesh", "crps_concurrent", &runCase<CRPSConcurrentFormat, raw::Mesh<>, MeshSpec> },
+        { "mesh", "boost", &runCase<BoostFormat, boost_tracked::Mesh, MeshSpec> },
+        { "scene", "shared_ptr", &runCase<CerealFormat, shared::Scene, SceneSpec> },
+        { "scene", "crps", &runCase<CRPSFormat, raw::Scene<>, SceneSpec> },
+        { "scene", "crps_concurrent", &runCase<CRPSConcurrentFormat, raw::Scene<>, SceneSpec> },
+        { "scene", "boost", &runCase<BoostFormat, boost_tracked::Scene, SceneSpec> },
+    };
+}
+
+int main(int argc, char** argv)
+{
+    bench::WorkloadOptions options;
+    options.size = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : options.size;
+    const unsigned repeat = argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 5;
+    options.density = argc > 3 ? std::strtod(argv[3], nullptr) : options.density;
+    if (options.size == 0 || repeat == 0 || options.density < 0 || (argc > 4 && !bench::parseDirection(argv[4], options.direction))) {
+        std::fprintf(stderr, "usage: %s [size] [repeat] [density] [backward|forward|mixed]\n", argv[0]);
+        return 2;
+    }
+
+    // shared_ptr and Boost follow pointers recursively, which exhausts the default stack on large scenes
+    rlimit stack{};
+    if (getrlimit(RLIMIT_STACK, &stack) == 0 && stack.rlim_cur != RLIM_INFINITY && stack.rlim_cur < stack.rlim_max)
+    {
+        stack.rlim_cur = stack.rlim_max;
+        setrlimit(RLIMIT_STACK, &stack);
+    }
+
+    std::printf("shape\tvariant\tdirection\tdensity\tsize\tsave_ms\tload_ms\tbytes\tsave_allocs\tload_allocs\tpeak_rss_kib\tverified\n");
+    std::fflush(stdout);
+
+    int status = 0;
+    for (bench::Case const& test : bench::cases)
+    {
+        const pid_t child = fork();
+        if (child == 0)
+        {
+            const bench::Result result = test.run(options, repeat);
+            rusage usage{};
+            getrusage(RUSAGE_SELF, &usage);
+            std::printf("%s\t%s\t%s\t%g\t%zu\t%.3f\t%.3f\t%zu\t%zu\t%zu\t%ld\t%s\n", test.shape, test.variant,
+                        bench::directionName(options.direction), options.density, options.size,
+                        result.save_ms, result.load_ms, result.bytes, result.save_allocations, result.load_allocations,
+                        usage.ru_maxrss, result.verified ? "yes" : "no");
+            std::fflush(stdout);
+            std::_Exit(result.verified ? 0 : 1);
+        }
+
+        int child_status = 0;
+        if (child < 0 || waitpid(child, &child_status, 0) < 0 || !WIFEXITED(child_status) || WEXITSTATUS(child_status) != 0)
+        {
+            if (child > 0 && WIFSIGNALED(child_status)) {
+                std::fprintf(stderr, "%s/%s failed by signal %d\n", test.shape, test.variant, WTERMSIG(child_status));
+            }
+            else {
+                std::fprintf(stderr, "%s/%s failed\n", test.shape, test.variant);
+            }
+            status = 1;
+        }
+    }
+    return status;
+}
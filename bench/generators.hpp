@@ -0,0 +1,558 @@
+#ifndef CRPS_BENCH_GENERATORS_HPP_
+#define CRPS_BENCH_GENERATORS_HPP_
+
+#include <crps/crps.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+/*! Reproducible pointer graphs of configurable shape, shared by the benchmarks.
+
+    Each shape has a spec, which describes the logical graph by object indexes
+    and is generated from WorkloadOptions, and a CRPS representation in
+    bench::raw, which is built from a spec and converts back to one, so that a
+    loaded graph can be compared with the generated spec. Equal options
+    generate equal specs on every platform with the same standard library.
+
+    @code{cpp}
+    bench::WorkloadOptions options;
+    options.size = 1 << 20;
+    options.direction = bench::Direction::Forward;
+    bench::raw::Scene<true> scene(bench::SceneSpec::generate(options));
+    @endcode
+*/
+namespace bench
+{
+    // ######################################################################
+    //! Direction of pointers relative to the serialization order of the objects they reference
+    enum class Direction
+    {
+        Backward,   //!< Pointers reference objects serialized before them
+        Forward,    //!< Pointers reference objects serialized after them
+        Mixed       //!< Pointers reference objects serialized before or after them
+    };
+
+    //! Parses "backward", "forward" or "mixed", returns false for other names
+    inline bool parseDirection(std::string const& name, Direction& direction)
+    {
+        if (name == "backward") {
+            direction = Direction::Backward;
+        }
+        else if (name == "forward") {
+            direction = Direction::Forward;
+        }
+        else if (name == "mixed") {
+            direction = Direction::Mixed;
+        }
+        else {
+            return false;
+        }
+        return true;
+    }
+
+    inline const char* directionName(Direction direction)
+    {
+        return direction == Direction::Backward ? "backward" : direction == Direction::Forward ? "forward" : "mixed";
+    }
+
+    //! Options shared by the generators of every shape
+    struct WorkloadOptions
+    {
+        std::size_t size{ 100000 };                     //!< Vertices, nodes or list elements
+        double density{ 2.0 };                          //!< Average pointers per object, for shapes with a variable number of pointers
+        Direction direction{ Direction::Backward };     //!< Direction of the pointers of variable number
+        std::uint32_t seed{ 5489u };                    //!< Seed of the generator
+    };
+
+    //! Draws a number of pointers, averaging density
+    inline std::size_t drawCount(double density, std::mt19937& random)
+    {
+        const double whole = std::floor(density);
+        return static_cast<std::size_t>(whole) + (std::uniform_real_distribution<double>(0, 1)(random) < density - whole ? 1 : 0);
+    }
+
+    /*! Draws the object referenced by a pointer of object, out of count objects in serialization order.
+        @returns False if no object is in direction of object */
+    inline bool drawTarget(std::size_t object, std::size_t count, Direction direction, std::mt19937& random, std::uint32_t& target)
+    {
+        std::size_t first = 0;
+        std::size_t last = count;
+        if (direction == Direction::Backward) {
+            last = object;
+        }
+        else if (direction == Direction::Forward) {
+            first = object + 1;
+        }
+        if (last <= first + (direction == Direction::Mixed ? 1 : 0)) {
+            return false;
+        }
+
+        if (direction == Direction::Mixed)
+        {
+            std::size_t drawn = std::uniform_int_distribution<std::size_t>(0, count - 2)(random);
+            target = static_cast<std::uint32_t>(drawn < object ? drawn : drawn + 1);
+        }
+        else {
+            target = static_cast<std::uint32_t>(std::uniform_int_distribution<std::size_t>(first, last - 1)(random));
+        }
+        return true;
+    }
+
+    // ######################################################################
+    //! A mesh of vertices, edges and faces, with edges referencing vertices like Example 2 of the README
+    /*! Each edge references a vertex and the targetA or targetB member of another
+        vertex, and each face references three consecutive edges. Density is the
+        number of edges per vertex. Direction selects the order in which vertices,
+        edges and faces are serialized: vertices first for Backward, faces first
+        for Forward, and edges first for Mixed. */
+    struct MeshSpec
+    {
+        std::size_t vertices{ 0 };
+        std::vector<std::uint32_t> from{};      //!< Vertex of each edge
+        std::vector<std::uint32_t> to{};        //!< Vertex of the target of each edge
+        std::vector<std::uint8_t> member{};     //!< 0 if the target of the edge is targetA, 1 if targetB
+        Direction order{ Direction::Backward }; //!< Serialization order of vertices, edges and faces
+
+        bool operator==(MeshSpec const& other) const
+        {
+            return vertices == other.vertices && from == other.from && to == other.to && member == other.member && order == other.order;
+        }
+
+        //! Faces of the mesh, face f references the edges 3f, 3f + 1 and 3f + 2
+        std::size_t faces() const
+        {
+            return from.size() / 3;
+        }
+
+        static MeshSpec generate(WorkloadOptions const& options)
+        {
+            std::mt19937 random(options.seed);
+            MeshSpec spec;
+            spec.vertices = options.size;
+            spec.order = options.direction;
+
+            const std::size_t edges = static_cast<std::size_t>(options.density * static_cast<double>(options.size) + 0.5);
+            std::uniform_int_distribution<std::uint32_t> vertex(0, static_cast<std::uint32_t>(options.size - 1));
+            for (std::size_t i = 0; i < edges; i++)
+            {
+                spec.from.push_back(static_cast<std::uint32_t>(i * options.size / edges));
+                spec.to.push_back(vertex(random));
+                spec.member.push_back(static_cast<std::uint8_t>(random() & 1));
+            }
+            return spec;
+        }
+    };
+
+    //! A scene tree, with nodes referencing their parent, their children and other nodes
+    /*! Each node is the child of a random earlier node, so parent pointers are
+        backward and child pointers forward in serialization order. Density is the
+        average number of references from a node to other nodes, such as the
+        targets of constraints, in direction. */
+    struct SceneSpec
+    {
+        std::vector<std::uint32_t> parent{};                //!< Parent of each node, the root is its own parent
+        std::vector<std::vector<std::uint32_t>> refs{};     //!< Nodes referenced by each node
+
+        bool operator==(SceneSpec const& other) const
+        {
+            return parent == other.parent && refs == other.refs;
+        }
+
+        static SceneSpec generate(WorkloadOptions const& options)
+        {
+            std::mt19937 random(options.seed);
+            SceneSpec spec;
+            spec.parent.push_back(0);
+            for (std::uint32_t i = 1; i < options.size; i++) {
+                spec.parent.push_back(std::uniform_int_distribution<std::uint32_t>(0, i - 1)(random));
+            }
+
+            spec.refs.resize(options.size);
+            for (std::size_t i = 0; i < options.size; i++)
+            {
+                const std::size_t count = drawCount(options.density, random);
+                std::uint32_t target;
+                for (std::size_t j = 0; j < count && drawTarget(i, options.size, options.direction, random, target); j++) {
+                    spec.refs[i].push_back(target);
+                }
+            }
+            return spec;
+        }
+    };
+
+    //! A scale-free graph of references, grown by preferential attachment
+    /*! Each new node links to a number of distinct earlier nodes averaging density,
+        chosen with probability proportional to the number of links they already
+        have, so a few nodes are referenced by a large share of the pointers. With
+        Backward direction the new node references the earlier nodes, with Forward
+        direction the earlier nodes reference the new node, and with Mixed direction
+        either, at random. */
+    struct ReferenceSpec
+    {
+        std::vector<std::vector<std::uint32_t>> refs{}; //!< Nodes referenced by each node
+
+        bool operator==(ReferenceSpec const& other) const
+        {
+            return refs == other.refs;
+        }
+
+        static ReferenceSpec generate(WorkloadOptions const& options)
+        {
+            std::mt19937 random(options.seed);
+            ReferenceSpec spec;
+            spec.refs.resize(options.size);
+
+            std::vector<std::uint32_t> ends{}; // both nodes of every link, for drawing nodes by their number of links
+            std::vector<std::uint32_t> linked{};
+            for (std::uint32_t i = 1; i < options.size; i++)
+            {
+                const std::size_t count = std::min<std::size_t>(std::max<std::size_t>(drawCount(options.density, random), 1), i);
+                linked.clear();
+                while (linked.size() < count)
+                {
+                    const std::uint32_t node = ends.empty() || (random() & 3) == 0
+                        ? std::uniform_int_distribution<std::uint32_t>(0, i - 1)(random)
+                        : ends[std::uniform_int_distribution<std::size_t>(0, ends.size() - 1)(random)];
+                    if (std::find(linked.begin(), linked.end(), node) == linked.end()) {
+                        linked.push_back(node);
+                    }
+                }
+
+                for (std::uint32_t node : linked)
+                {
+                    const bool backward = options.direction == Direction::Backward || (options.direction == Direction::Mixed && (random() & 1) != 0);
+                    if (backward) {
+                        spec.refs[i].push_back(node);
+                    }
+                    else {
+                        spec.refs[node].push_back(i);
+                    }
+                    ends.push_back(node);
+                    ends.push_back(i);
+                }
+            }
+            return spec;
+        }
+    };
+
+    //! Element index of the end of a list
+    const std::uint32_t list_end = std::numeric_limits<std::uint32_t>::max();
+
+    //! A long singly linked intrusive list
+    /*! The elements are serialized in storage order. With Forward direction each
+        element links to the next element in storage, with Backward direction to the
+        previous element, and with Mixed direction the list visits the elements in a
+        random order. Density does not apply, every element has one pointer. */
+    struct ListSpec
+    {
+        std::uint32_t head{ 0 };            //!< First element of the list, or list_end if empty
+        std::vector<std::uint32_t> next{};  //!< Next element of each element, or list_end for the last element
+
+        bool operator==(ListSpec const& other) const
+        {
+            return head == other.head && next == other.next;
+        }
+
+        static ListSpec generate(WorkloadOptions const& options)
+        {
+            std::vector<std::uint32_t> order(options.size);
+            for (std::size_t i = 0; i < order.size(); i++) {
+                order[i] = static_cast<std::uint32_t>(options.direction == Direction::Backward ? order.size() - 1 - i : i);
+            }
+            if (options.direction == Direction::Mixed) {
+                std::mt19937 random(options.seed);
+                std::shuffle(order.begin(), order.end(), random);
+            }
+
+            ListSpec spec;
+            spec.next.assign(options.size, list_end);
+            spec.head = order.empty() ? list_end : order[0];
+            for (std::size_t i = 1; i < order.size(); i++) {
+                spec.next[order[i - 1]] = order[i];
+            }
+            return spec;
+        }
+    };
+
+    //! Serializes crps::this_ptr(object) if ThisPtr is true, so the object registers its own address
+    template <bool ThisPtr>
+    struct ThisPointers
+    {
+        template <class Archive, class T>
+        static void serialize(Archive& ar, T* object)
+        {
+            ar(crps::this_ptr(object));
+        }
+    };
+
+    template <>
+    struct ThisPointers<false>
+    {
+        template <class Archive, class T>
+        static void serialize(Archive&, T*) {}
+    };
+
+    //! Index of the object referenced by ptr, in the contiguous objects starting at first
+    template <class T, class U>
+    std::uint32_t indexOf(const U* ptr, const T* first)
+    {
+        return static_cast<std::uint32_t>(static_cast<std::size_t>(reinterpret_cast<const char*>(ptr) - reinterpret_cast<const char*>(first)) / sizeof(T));
+    }
+
+    // ######################################################################
+    //! Objects are stored by value in vectors and referenced by CRPS raw pointers
+    /*! With ThisPtr, every object also serializes crps::this_ptr(this). */
+    namespace raw
+    {
+        template <bool ThisPtr = false>
+        struct Mesh
+        {
+            struct Vertex
+            {
+                std::uint32_t id;
+                float targetA;
+                float targetB;
+
+                template <class Archive>
+                void serialize(Archive& ar) { ar(id, targetA, targetB); ThisPointers<ThisPtr>::serialize(ar, this); }
+            };
+
+            struct Edge
+            {
+                crps::raw_ptr<Vertex> vertex;
+                crps::raw_ptr<float> target; //!< References targetA or targetB of a vertex
+
+                template <class Archive>
+                void serialize(Archive& ar) { ar(vertex, target); ThisPointers<ThisPtr>::serialize(ar, this); }
+            };
+
+            struct Face
+            {
+                crps::raw_ptr<Edge> first;
+                crps::raw_ptr<Edge> second;
+                crps::raw_ptr<Edge> third;
+
+                template <class Archive>
+                void serialize(Archive& ar) { ar(first, second, third); ThisPointers<ThisPtr>::serialize(ar, this); }
+            };
+
+            std::vector<Vertex> vertices{};
+            std::vector<Edge> edges{};
+            std::vector<Face> faces{};
+            std::uint8_t order{ 0 }; //!< Direction, the serialization order of vertices, edges and faces
+
+            Mesh() = default;
+
+            explicit Mesh(MeshSpec const& spec) : order(static_cast<std::uint8_t>(spec.order))
+            {
+                for (std::size_t i = 0; i < spec.vertices; i++) {
+                    vertices.push_back(Vertex{ static_cast<std::uint32_t>(i), float(i), float(i) + 0.5f });
+                }
+                for (std::size_t i = 0; i < spec.from.size(); i++)
+                {
+                    Vertex& target = vertices[spec.to[i]];
+                    edges.push_back(Edge{ &vertices[spec.from[i]], spec.member[i] ? &target.targetB : &target.targetA });
+                }
+                for (std::size_t i = 0; i < spec.faces(); i++) {
+                    faces.push_back(Face{ &edges[3 * i], &edges[3 * i + 1], &edges[3 * i + 2] });
+                }
+            }
+
+            MeshSpec spec() const
+            {
+                MeshSpec result;
+                result.vertices = vertices.size();
+                result.order = static_cast<Direction>(order);
+                for (Edge const& edge : edges)
+                {
+                    const std::uint32_t to = indexOf(edge.target.ptr, vertices.data());
+                    result.from.push_back(indexOf(edge.vertex.ptr, vertices.data()));
+                    result.to.push_back(to);
+                    result.member.push_back(edge.target.ptr == &vertices[to].targetB ? 1 : 0);
+                }
+                for (std::size_t i = 0; i < faces.size(); i++)
+                {
+                    Face const& face = faces[i];
+                    if (face.first.ptr != &edges[3 * i] || face.second.ptr != &edges[3 * i + 1] || face.third.ptr != &edges[3 * i + 2]) {
+                        result.vertices = 0;
+                    }
+                }
+                return result;
+            }
+
+            template <class Archive>
+            void serialize(Archive& ar)
+            {
+                ar(order);
+                switch (static_cast<Direction>(order))
+                {
+                case Direction::Backward:
+                    ar(vertices, edges, faces);
+                    break;
+                case Direction::Forward:
+                    ar(faces, edges, vertices);
+                    break;
+                case Direction::Mixed:
+                    ar(edges, vertices, faces);
+                    break;
+                }
+            }
+        };
+
+        template <bool ThisPtr = false>
+        struct Scene
+        {
+            struct Node
+            {
+                std::uint32_t id;
+                float x, y, z;
+                crps::raw_ptr<Node> parent;
+                std::vector<crps::raw_ptr<Node>> children;
+                std::vector<crps::raw_ptr<Node>> refs;
+
+                template <class Archive>
+                void serialize(Archive& ar) { ar(id, x, y, z, parent, children, refs); ThisPointers<ThisPtr>::serialize(ar, this); }
+            };
+
+            std::vector<Node> nodes{};
+
+            Scene() = default;
+
+            explicit Scene(SceneSpec const& spec)
+            {
+                for (std::size_t i = 0; i < spec.parent.size(); i++) {
+                    nodes.push_back(Node{ static_cast<std::uint32_t>(i), float(i), 0.0f, 0.0f, nullptr, {}, {} });
+                }
+                for (std::size_t i = 0; i < nodes.size(); i++)
+                {
+                    if (i != 0) {
+                        nodes[i].parent = &nodes[spec.parent[i]];
+                        nodes[spec.parent[i]].children.push_back(&nodes[i]);
+                    }
+                    for (std::uint32_t ref : spec.refs[i]) {
+                        nodes[i].refs.push_back(&nodes[ref]);
+                    }
+                }
+            }
+
+            SceneSpec spec() const
+            {
+                SceneSpec result;
+                for (Node const& node : nodes)
+                {
+                    result.parent.push_back(node.parent.ptr ? indexOf(node.parent.ptr, nodes.data()) : node.id);
+                    result.refs.emplace_back();
+                    for (crps::raw_ptr<Node> const& ref : node.refs) {
+                        result.refs.back().push_back(indexOf(ref.ptr, nodes.data()));
+                    }
+                    for (crps::raw_ptr<Node> const& child : node.children)
+                    {
+                        if (child.ptr->parent.ptr != &node) {
+                            result.parent.assign(1, std::numeric_limits<std::uint32_t>::max());
+                            return result;
+                        }
+                    }
+                }
+                return result;
+            }
+
+            template <class Archive>
+            void serialize(Archive& ar) { ar(nodes); }
+        };
+
+        template <bool ThisPtr = false>
+        struct References
+        {
+            struct Node
+            {
+                std::uint32_t id;
+                std::vector<crps::raw_ptr<Node>> refs;
+
+                template <class Archive>
+                void serialize(Archive& ar) { ar(id, refs); ThisPointers<ThisPtr>::serialize(ar, this); }
+            };
+
+            std::vector<Node> nodes{};
+
+            References() = default;
+
+            explicit References(ReferenceSpec const& spec)
+            {
+                for (std::size_t i = 0; i < spec.refs.size(); i++) {
+                    nodes.push_back(Node{ static_cast<std::uint32_t>(i), {} });
+                }
+                for (std::size_t i = 0; i < nodes.size(); i++)
+                {
+                    for (std::uint32_t ref : spec.refs[i]) {
+                        nodes[i].refs.push_back(&nodes[ref]);
+                    }
+                }
+            }
+
+            ReferenceSpec spec() const
+            {
+                ReferenceSpec result;
+                for (Node const& node : nodes)
+                {
+                    result.refs.emplace_back();
+                    for (crps::raw_ptr<Node> const& ref : node.refs) {
+                        result.refs.back().push_back(indexOf(ref.ptr, nodes.data()));
+                    }
+                }
+                return result;
+            }
+
+            template <class Archive>
+            void serialize(Archive& ar) { ar(nodes); }
+        };
+
+        template <bool ThisPtr = false>
+        struct List
+        {
+            struct Element
+            {
+                double value;
+                crps::raw_ptr<Element> next;
+
+                template <class Archive>
+                void serialize(Archive& ar) { ar(value, next); ThisPointers<ThisPtr>::serialize(ar, this); }
+            };
+
+            std::vector<Element> elements{};
+            crps::raw_ptr<Element> head{};
+
+            List() = default;
+
+            explicit List(ListSpec const& spec)
+            {
+                for (std::size_t i = 0; i < spec.next.size(); i++) {
+                    elements.push_back(Element{ double(i), nullptr });
+                }
+                for (std::size_t i = 0; i < elements.size(); i++) {
+                    elements[i].next = spec.next[i] == list_end ? nullptr : &elements[spec.next[i]];
+                }
+                head = spec.head == list_end ? nullptr : &elements[spec.head];
+            }
+
+            ListSpec spec() const
+            {
+                ListSpec result;
+                result.head = head.ptr ? indexOf(head.ptr, elements.data()) : list_end;
+                for (Element const& element : elements) {
+                    result.next.push_back(element.next.ptr ? indexOf(element.next.ptr, elements.data()) : list_end);
+                }
+                return result;
+            }
+
+            template <class Archive>
+            void serialize(Archive& ar) { ar(elements, head); }
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,129 @@
+/*! Times CRPS saves to a sink of limited bandwidth, written directly by
+    CRPSOutputArchive and through CRPSPipelinedOutputArchive.
+
+    The sink sleeps for the given microseconds per 64 KiB written, like a
+    disk or network of that bandwidth, so the time of a direct save is about
+    the traversal time plus the write time, and the time of a pipelined save
+    approaches the longer of the two. A sink without delay gives the traversal
+    time alone. Times are the best of the repeated runs, and are written to
+    stdout as tab separated columns. The graph is a mesh generated by
+    bench/generators.hpp.
+
+    Build and run:
+
+        g++ -std=c++11 -O2 -pthread -Iinclude -I<cereal>/include bench/pipeline.cpp -o pipeline
+        ./pipeline [size] [repeat] [microseconds per 64 KiB]
+*/
+
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/vector.hpp>
+#include <crps/pipeline.hpp>
+
+#include "generators.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <streambuf>
+#include <thread>
+
+namespace bench
+{
+    //! Discards its output, sleeping for delay per 64 KiB written
+    class ThrottledBuffer : public std::streambuf
+    {
+    public:
+        explicit ThrottledBuffer(std::chrono::microseconds delay) : delay(delay) {}
+
+        std::size_t size() const
+        {
+            return written;
+        }
+
+    protected:
+        std::streamsize xsputn(const char*, std::streamsize n) override
+        {
+            charge(static_cast<std::size_t>(n));
+            return n;
+        }
+
+        int_type overflow(int_type ch) override
+        {
+            charge(1);
+            return traits_type::not_eof(ch);
+        }
+
+    private:
+        //! Counts bytes written, and sleeps for every 64 KiB completed
+        void charge(std::size_t bytes)
+        {
+            const std::size_t blocks = (written + bytes) / block_size - written / block_size;
+            written += bytes;
+            if (blocks != 0 && delay.count() != 0) {
+                std::this_thread::sleep_for(delay * static_cast<long>(blocks));
+            }
+        }
+
+        static const std::size_t block_size = 64 * 1024;
+
+        std::chrono::microseconds delay;
+        std::size_t written{ 0 };
+    };
+
+    //! Best time in milliseconds of repeat runs of save on a fresh sink of delay per 64 KiB
+    template <class Save>
+    double timeSaves(std::size_t repeat, std::chrono::microseconds delay, Save&& save)
+    {
+        double best = 0.0;
+        for (std::size_t i = 0; i < repeat; i++)
+        {
+            ThrottledBuffer buffer(delay);
+            std::ostream sink(&buffer);
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            save(sink);
+            const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            best = i == 0 || elapsed < best ? elapsed : best;
+        }
+        return best;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bench::WorkloadOptions options;
+    options.size = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    const std::size_t repeat = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 5;
+    const std::chrono::microseconds delay(argc > 3 ? std::strtol(argv[3], nullptr, 10) : 1000);
+    if (options.size == 0 || repeat == 0)
+    {
+        std::fprintf(stderr, "usage: pipeline [size] [repeat] [microseconds per 64 KiB]\n");
+        return 2;
+    }
+
+    const bench::raw::Mesh<> mesh(bench::MeshSpec::generate(options));
+    auto direct = [&](std::ostream& sink) {
+        cereal::BinaryOutputArchive oarchive(sink);
+        crps::CRPSOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+        crps_oarchive(mesh);
+        crps_oarchive.complete();
+    };
+    auto pipelined = [&](std::ostream& sink, std::size_t buffer_size, std::size_t buffer_count) {
+        crps::CRPSPipelinedOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(sink, buffer_size, buffer_count);
+        crps_oarchive(mesh);
+        crps_oarchive.complete();
+    };
+
+    std::printf("variant\tsink_us_per_64k\tsave_ms\n");
+    for (std::chrono::microseconds sink_delay : { std::chrono::microseconds(0), delay })
+    {
+        std::printf("direct\t%ld\t%.1f\n", static_cast<long>(sink_delay.count()),
+                    bench::timeSaves(repeat, sink_delay, direct));
+        const std::size_t buffers[][2] = { { std::size_t(64) << 10, 2 }, { std::size_t(1) << 20, 2 }, { std::size_t(1) << 20, 16 } };
+        for (auto const& buffer : buffers)
+        {
+            std::printf("pipelined_%zux%zuk\t%ld\t%.1f\n", buffer[1], buffer[0] >> 10, static_cast<long>(sink_delay.count()),
+                        bench::timeSaves(repeat, sink_delay, [&](std::ostream& sink) { pipelined(sink, buffer[0], buffer[1]); }));
+        }
+    }
+    return 0;
+}
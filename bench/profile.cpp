@@ -0,0 +1,370 @@
+/*! Profiles the heap traffic and peak memory of CRPS saves and loads.
+
+    Every shape is profiled in its own process, in phases:
+
+        build       constructing the payload objects of the graph
+        user_save   saving the graph with the user archive alone
+        crps_save   saving the graph through CRPSOutputArchive
+        mapper_save traversing the graph with CRPSOutputMapper alone and
+                    generating its pointer table
+        user_load   loading the graph with the user archive alone
+        crps_load   loading the graph through CRPSInputArchive
+
+    The mapper_save phase allocates nothing but the pointer book-keeping of a
+    save, so its heap traffic is that of the book-keeping, whichever backend,
+    address runs or spill files the mapper uses. It is reported with the
+    stats of the mapper. The book-keeping of a load is interleaved with the
+    loading of the payload, so it is reported as bookkeeping_load, the
+    difference between the crps_load and user_load phases. Its fixups are one
+    function pointer per pointer, stored in one vector, so they show up as
+    regrowths rather than as an allocation per pointer. Saves write to a
+    stream that only counts bytes, so output buffering does not allocate.
+
+    Allocations are counted by a replaced global operator new, and classified
+    as regrowths when the next allocator call frees a smaller block, as
+    vectors and hash tables do when they grow. Peak heap is the highest amount
+    of live allocated bytes during the phase, and peak RSS is read from VmHWM
+    after resetting it through /proc/self/clear_refs.
+
+    The graphs are generated by bench/generators.hpp from the size, density and
+    direction arguments. The report is written to stdout as JSON. Build and
+    run, on Linux:
+
+        g++ -std=c++11 -O2 -Iinclude -I<cereal>/include bench/profile.cpp -o profile
+        ./profile [size] [density] [backward|forward|mixed] > profile.json
+*/
+
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/vector.hpp>
+#include <crps/crps.hpp>
+
+#include "generators.hpp"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+    // ######################################################################
+    //! Heap traffic of a phase
+    struct HeapCounters
+    {
+        std::size_t allocations{ 0 };
+        std::size_t bytes{ 0 };
+        std::size_t regrowths{ 0 };
+        std::size_t regrowth_bytes{ 0 };
+        std::size_t peak_live_bytes{ 0 }; //!< Highest live bytes above those live when the phase started
+    };
+
+    namespace heap
+    {
+        //! Every block is prefixed by its size, padded to keep the alignment of operator new
+        const std::size_t header_size = alignof(std::max_align_t) > sizeof(std::size_t) ? alignof(std::max_align_t) : sizeof(std::size_t);
+
+        HeapCounters counters{};        //!< Counters of the current phase
+        std::size_t live_bytes{ 0 };    //!< Bytes allocated and not freed
+        std::size_t phase_live_bytes{ 0 }; //!< Live bytes when the current phase started
+
+        std::size_t pending_size{ 0 };  //!< Size of the last allocation, while no other allocator call followed it
+        void* pending_block{ nullptr }; //!< Address of the last allocation, while no other allocator call followed it
+
+        void beginPhase()
+        {
+            counters = HeapCounters{};
+            phase_live_bytes = live_bytes;
+            pending_block = nullptr;
+        }
+
+        void allocated(void* block, std::size_t size)
+        {
+            counters.allocations++;
+            counters.bytes += size;
+            live_bytes += size;
+            if (live_bytes > phase_live_bytes) {
+                counters.peak_live_bytes = std::max(counters.peak_live_bytes, live_bytes - phase_live_bytes);
+            }
+            pending_size = size;
+            pending_block = block;
+        }
+
+        void freed(void* block, std::size_t size)
+        {
+            if (pending_block != nullptr && pending_block != block && size < pending_size) {
+                counters.regrowths++;
+                counters.regrowth_bytes += pending_size;
+            }
+            live_bytes -= size;
+            pending_block = nullptr;
+        }
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    char* block = static_cast<char*>(std::malloc(bench::heap::header_size + size));
+    if (block == nullptr) {
+        throw std::bad_alloc();
+    }
+    std::memcpy(block, &size, sizeof(size));
+    bench::heap::allocated(block + bench::heap::header_size, size);
+    return block + bench::heap::header_size;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if (ptr == nullptr) {
+        return;
+    }
+    char* block = static_cast<char*>(ptr) - bench::heap::header_size;
+    std::size_t size;
+    std::memcpy(&size, block, sizeof(size));
+    bench::heap::freed(ptr, size);
+    std::free(block);
+}
+
+namespace bench
+{
+    // ######################################################################
+    //! Counts the bytes written to it, without storing them
+    class CountingBuffer : public std::streambuf
+    {
+    public:
+        std::size_t size() const
+        {
+            return count;
+        }
+
+    protected:
+        std::streamsize xsputn(const char*, std::streamsize n) override
+        {
+            count += static_cast<std::size_t>(n);
+            return n;
+        }
+
+        int_type overflow(int_type ch) override
+        {
+            count++;
+            return traits_type::not_eof(ch);
+        }
+
+    private:
+        std::size_t count{ 0 };
+    };
+
+    //! Resets the peak RSS of the process, returns false if not supported
+    inline bool resetPeakRSS()
+    {
+        std::ofstream clear_refs("/proc/self/clear_refs");
+        return static_cast<bool>(clear_refs << "5");
+    }
+
+    //! Peak RSS of the process in KiB, since the last resetPeakRSS
+    inline long peakRSS()
+    {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line))
+        {
+            if (line.compare(0, 6, "VmHWM:") == 0) {
+                return std::strtol(line.c_str() + 6, nullptr, 10);
+            }
+        }
+        return -1;
+    }
+
+    //! Counters and peak RSS of a phase
+    struct Phase
+    {
+        HeapCounters heap;
+        long peak_rss_kib;
+    };
+
+    //! Runs one phase of the profile
+    template <class Function>
+    Phase profile(Function&& function)
+    {
+        resetPeakRSS();
+        heap::beginPhase();
+        function();
+        const HeapCounters counters = heap::counters;
+        return Phase{ counters, peakRSS() };
+    }
+
+    // ######################################################################
+    //! Writes the counters of a phase as a JSON object
+    inline void writeCounters(std::ostream& os, HeapCounters const& counters)
+    {
+        os << "\"allocations\": " << counters.allocations
+           << ", \"bytes\": " << counters.bytes
+           << ", \"regrowths\": " << counters.regrowths
+           << ", \"regrowth_bytes\": " << counters.regrowth_bytes
+           << ", \"peak_heap_bytes\": " << counters.peak_live_bytes;
+    }
+
+    //! Difference of the counters of a phase with CRPS and the same phase with the user archive alone
+    inline HeapCounters bookkeeping(HeapCounters const& crps, HeapCounters const& user)
+    {
+        auto difference = [](std::size_t a, std::size_t b) { return a > b ? a - b : 0; };
+        HeapCounters result;
+        result.allocations = difference(crps.allocations, user.allocations);
+        result.bytes = difference(crps.bytes, user.bytes);
+        result.regrowths = difference(crps.regrowths, user.regrowths);
+        result.regrowth_bytes = difference(crps.regrowth_bytes, user.regrowth_bytes);
+        result.peak_live_bytes = difference(crps.peak_live_bytes, user.peak_live_bytes);
+        return result;
+    }
+
+    //! Profiles the phases of a graph built from spec, and writes them as a JSON object
+    template <class Graph, class Spec>
+    bool profileShape(const char* shape, Spec const& spec, std::ostream& os)
+    {
+        std::unique_ptr<Graph> graph;
+        const Phase build = profile([&] { graph.reset(new Graph(spec)); });
+
+        CountingBuffer user_output;
+        const Phase user_save = profile([&] {
+            std::ostream stream(&user_output);
+            cereal::BinaryOutputArchive oarchive(stream);
+            oarchive(*graph);
+        });
+
+        std::ostringstream saved;
+        {
+            cereal::BinaryOutputArchive oarchive(saved);
+            crps::CRPSOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+            crps_oarchive(*graph);
+        }
+        CountingBuffer crps_output;
+        const Phase crps_save = profile([&] {
+            std::ostream stream(&crps_output);
+            cereal::BinaryOutputArchive oarchive(stream);
+            crps::CRPSOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+            crps_oarchive(*graph);
+        });
+
+        crps::CRPSMapperStats stats{};
+        const Phase mapper_save = profile([&] {
+            crps::CRPSOutputMapper mapper;
+            mapper(*graph);
+            const std::vector<std::uint32_t> table = mapper.pointerTable();
+            stats = mapper.stats();
+        });
+        graph.reset();
+
+        const std::string bytes = saved.str();
+        std::unique_ptr<Graph> user_loaded(new Graph());
+        std::istringstream user_input(bytes);
+        const Phase user_load = profile([&] {
+            cereal::BinaryInputArchive iarchive(user_input);
+            iarchive(*user_loaded);
+        });
+        user_loaded.reset();
+
+        std::unique_ptr<Graph> loaded(new Graph());
+        std::istringstream crps_input(bytes);
+        const Phase crps_load = profile([&] {
+            cereal::BinaryInputArchive iarchive(crps_input);
+            crps::CRPSInputArchive<cereal::BinaryInputArchive> crps_iarchive(iarchive);
+            crps_iarchive(*loaded);
+        });
+        const bool verified = loaded->spec() == spec;
+
+        const std::pair<const char*, Phase const*> phases[] = {
+            { "build", &build }, { "user_save", &user_save }, { "crps_save", &crps_save }, { "mapper_save", &mapper_save },
+            { "user_load", &user_load }, { "crps_load", &crps_load }
+        };
+        os << "    {\"shape\": \"" << shape << "\", \"user_bytes\": " << user_output.size()
+           << ", \"crps_bytes\": " << crps_output.size() << ", \"verified\": " << (verified ? "true" : "false") << ",\n";
+        os << "     \"mapper\": {\"backend\": \"" << (stats.backend == crps::CRPSBackend::Hash ? "hash" : "sorted_log")
+           << "\", \"objects\": " << stats.objects << ", \"pointers\": " << stats.pointers
+           << ", \"table_entries\": " << stats.table_entries << ", \"address_runs\": " << stats.address_runs << "},\n";
+        os << "     \"phases\": {\n";
+        for (auto const& phase : phases)
+        {
+            os << "       \"" << phase.first << "\": {";
+            writeCounters(os, phase.second->heap);
+            os << ", \"peak_rss_kib\": " << phase.second->peak_rss_kib << "},\n";
+        }
+        os << "       \"bookkeeping_load\": {";
+        writeCounters(os, bookkeeping(crps_load.heap, user_load.heap));
+        os << "}}}";
+        return verified;
+    }
+
+    //! A shape, profiled in a process of its own
+    struct Shape
+    {
+        const char* name;
+        bool (*run)(const char* name, WorkloadOptions const& options, std::ostream& os);
+    };
+
+    template <class Graph, class Spec>
+    bool runShape(const char* name, WorkloadOptions const& options, std::ostream& os)
+    {
+        return profileShape<Graph>(name, Spec::generate(options), os);
+    }
+
+    const Shape shapes[] = {
+        { "mesh", &runShape<raw::Mesh<>, MeshSpec> },
+        { "scene", &runShape<raw::Scene<>, SceneSpec> },
+        { "scene_this_ptr", &runShape<raw::Scene<true>, SceneSpec> },
+        { "references", &runShape<raw::References<>, ReferenceSpec> },
+        { "list", &runShape<raw::List<>, ListSpec> },
+    };
+}
+
+int main(int argc, char** argv)
+{
+    bench::WorkloadOptions options;
+    options.size = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : options.size;
+    options.density = argc > 2 ? std::strtod(argv[2], nullptr) : options.density;
+    if (options.size == 0 || options.density < 0 || (argc > 3 && !bench::parseDirection(argv[3], options.direction))) {
+        std::fprintf(stderr, "usage: %s [size] [density] [backward|forward|mixed]\n", argv[0]);
+        return 2;
+    }
+
+    std::printf("{\"size\": %zu, \"density\": %g, \"direction\": \"%s\", \"shapes\": [\n",
+                options.size, options.density, bench::directionName(options.direction));
+    std::fflush(stdout);
+
+    int status = 0;
+    bool first = true;
+    for (bench::Shape const& shape : bench::shapes)
+    {
+        if (!first) {
+            std::printf(",\n");
+        }
+        first = false;
+        std::fflush(stdout);
+
+        const pid_t child = fork();
+        if (child == 0)
+        {
+            std::ostringstream report;
+            const bool verified = shape.run(shape.name, options, report);
+            std::fputs(report.str().c_str(), stdout);
+            std::fflush(stdout);
+            std::_Exit(verified ? 0 : 1);
+        }
+
+        int child_status = 0;
+        if (child < 0 || waitpid(child, &child_status, 0) < 0 || !WIFEXITED(child_status) || WEXITSTATUS(child_status) != 0)
+        {
+            std::fprintf(stderr, "%s failed\n", shape.name);
+            status = 1;
+        }
+    }
+    std::printf("\n]}\n");
+    return status;
+}
@@ -0,0 +1,532 @@
+#ifndef CRPS_BINARY_HPP_
+#define CRPS_BINARY_HPP_
+
+#include "crps/crps.hpp"
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+
+namespace crps
+{
+inline namespace CRPS_TRACE_NAMESPACE
+{
+    // ######################################################################
+    //! A binary output archive with built-in pointer book-keeping.
+    /*! Writes values as cereal::BinaryOutputArchive does, while tracking object
+        addresses and pointer values in the same traversal, so the object graph
+        is traversed once instead of twice as by CRPSOutputArchive. Output is
+        collected in a buffer and written to the stream in blocks. The pointer-id
+        to object-id map is saved and the buffer is flushed by complete, or by
+        ~BinaryOutputArchive.
+
+        The output is identical to CRPSOutputArchive<cereal::BinaryOutputArchive>,
+        so it may be loaded by either crps::BinaryInputArchive or
+        CRPSInputArchive<cereal::BinaryInputArchive>. The byte order is that of
+        the platform. FragmentCache cannot be used with this archive.
+
+        @code{cpp}
+        std::ofstream os("out.cereal", std::ios::binary);
+        crps::BinaryOutputArchive oarchive(os);
+        oarchive(vertices, edges);
+        @endcode
+
+        @ingroup Utility */
+    class BinaryOutputArchive : public cereal::OutputArchive<BinaryOutputArchive, cereal::AllowEmptyClassElision>, public detail::CRPSMapperCore
+    {
+    public:
+
+        /*! @param stream The stream to write to, which must outlive the archive
+            @param buffer_size Size in bytes of the output buffer, larger writes bypass the buffer */
+        BinaryOutputArchive(std::ostream& stream, std::size_t buffer_size = 1 << 16) :
+            OutputArchive<BinaryOutputArchive, cereal::AllowEmptyClassElision>(this),
+            stream(stream),
+            buffer(buffer_size)
+        {
+
+        }
+
+        /*! Complete defered action if not completed. */
+        ~BinaryOutputArchive()
+        {
+            complete();
+        }
+
+        /*! Generates pointer book-keeping, saves it, and flushes the output buffer to the stream.
+            @throws CRPSException If pointer-booking serialization or writing to the stream fails.
+        */
+        void complete()
+        {
+            if (completed) {
+                return;
+            }
+            completed = true;
+
+            serializeDeferments();
+
+            const std::vector<std::uint32_t> raw_to_obj = pointer_mapper.pointerTable();
+            const std::uint64_t count = raw_to_obj.size();
+            write(&count, sizeof(count));
+            write(raw_to_obj.data(), raw_to_obj.size() * sizeof(std::uint32_t));
+            flush();
+        }
+
+        //! Save pointers to objects not found in the traversal as external object-ids of objects, if tracked by objects
+        void setExternalObjects(ExternalObjects const& objects)
+        {
+            pointer_mapper.setExternalObjects(objects);
+        }
+
+        //! Keeps pointer book-keeping within about budget bytes of memory, see CRPSOutputArchive::setSpillBudget
+        void setSpillBudget(std::size_t budget)
+        {
+            pointer_mapper.setSpillBudget(budget);
+        }
+
+        //! Throws a CRPSException from the serialization that makes the pointer book-keeping exceed limits
+        void setLimits(CRPSLimits const& limits)
+        {
+            pointer_mapper.setLimits(limits);
+        }
+
+        //! Selects the index of tracked objects, see CRPSOutputArchive::setBackend
+        void setBackend(CRPSBackend backend)
+        {
+            pointer_mapper.setBackend(backend);
+        }
+
+        //! Statistics of the pointer book-keeping, including the selected backend
+        CRPSMapperStats stats() const
+        {
+            return pointer_mapper.stats();
+        }
+
+        /*! Writes a block of bytes to the output buffer.
+            @throws CRPSException If called after complete, or if writing to the stream fails.
+        */
+        void saveBinary(const void* data, std::size_t size)
+        {
+            if (completed) {
+                throw CRPSException("Attempted serialization after BinaryOutputArchive::complete called");
+            }
+            write(data, size);
+        }
+
+        //! Serializes types, see handle
+        template <class ... Types> inline
+        BinaryOutputArchive& operator()(Types&& ... args)
+        {
+            handle(std::forward<Types>(args)...);
+            return *this;
+        }
+
+        //! This is a boost compatability layer.
+        template <class T> inline
+        BinaryOutputArchive& operator&(T&& arg)
+        {
+            handle(std::forward<T>(arg));
+            return *this;
+        }
+
+        //! This is a boost compatability layer.
+        template <class T> inline
+        BinaryOutputArchive& operator<<(T&& arg)
+        {
+            handle(std::forward<T>(arg));
+            return *this;
+        }
+
+        //! Associate the object memory address with next object id
+        template <class T> inline
+        void trackAddress(T const& t)
+        {
+            pointer_mapper.trackAddress(t);
+        }
+
+        //! Associate the pointer value with next pointer id, and track it as an object
+        template <class T> inline
+        void trackPointer(T* const& p)
+        {
+            pointer_mapper.trackPointer(p);
+        }
+
+        //! Associate each of count elements of stride bytes, starting at data, with the next object id
+        void trackRange(const void* data, std::size_t stride, std::size_t count)
+        {
+            pointer_mapper.trackRange(data, stride, count);
+        }
+
+    private:
+
+        /*! Serializes types as the cereal archive does.
+            A failed serialization, as when the limits are exceeded or the user serialization
+            or the stream fails, leaves the archive completed, so that ~BinaryOutputArchive does not
+            save book-keeping for a partial traversal.
+            @throws CRPSException If attempted serialization after BinaryOutputArchive::complete called.
+        */
+        template <class ... Types> inline
+        void handle(Types&& ... args)
+        {
+            if (completed) {
+                throw CRPSException("Attempted serialization after BinaryOutputArchive::complete called");
+            }
+
+            try {
+                OutputArchive<BinaryOutputArchive, cereal::AllowEmptyClassElision>::operator()(std::forward<Types>(args)...);
+            }
+            catch (...) {
+                completed = true;
+                throw;
+            }
+        }
+
+        //! Copies bytes into the output buffer, writing the buffer to the stream when full
+        void write(const void* data, std::size_t size)
+        {
+            if (size > buffer.size() - used)
+            {
+                flush();
+                if (size >= buffer.size()) {
+                    writeStream(data, size);
+                    return;
+                }
+            }
+            std::memcpy(buffer.data() + used, data, size);
+            used += size;
+        }
+
+        //! Writes the output buffer to the stream
+        void flush()
+        {
+            writeStream(buffer.data(), used);
+            used = 0;
+        }
+
+        /*! Writes bytes to the stream.
+            @throws CRPSException If fewer bytes are written. */
+        void writeStream(const void* data, std::size_t size)
+        {
+            if (size == 0) {
+                return;
+            }
+            const std::streamsize written = stream.rdbuf()->sputn(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            if (written != static_cast<std::streamsize>(size)) {
+                throw CRPSException("Failed to write " + std::to_string(size) + " bytes to output stream! Wrote " + std::to_string(written));
+            }
+        }
+
+    private:
+        std::ostream& stream; //!< User provided output stream
+
+        std::vector<char> buffer; //!< Output that is not yet written to the stream
+        std::size_t used{}; //!< Number of bytes of buffer in use
+
+        CRPSOutputMapper pointer_mapper; //!< Object and pointer tables, filled by this archive's traversal
+
+        bool completed{ false }; //!< True if the pointer book-keeping has been saved
+    };
+
+    // ######################################################################
+    //! A binary input archive with built-in pointer book-keeping.
+    /*! Reads values as cereal::BinaryInputArchive does, while tracking object
+        addresses and pointer locations in the same traversal. Pointers are
+        initialized by complete, or by ~BinaryInputArchive.
+
+        Objects are tracked at the address they are loaded to, so objects that
+        are moved by their container after loading, such as the elements of
+        std::map, std::set and unordered containers, cannot be pointer targets.
+        CRPSInputArchive<cereal::BinaryInputArchive> supports such graphs.
+
+        @code{cpp}
+        std::ifstream is("out.cereal", std::ios::binary);
+        crps::BinaryInputArchive iarchive(is);
+        iarchive(vertices, edges);
+        iarchive.complete();
+        @endcode
+
+        @ingroup Utility */
+    class BinaryInputArchive : public cereal::InputArchive<BinaryInputArchive, cereal::AllowEmptyClassElision>, public detail::CRPSMapperCore
+    {
+    public:
+
+        /*! @param stream The stream to read from, which must outlive the archive */
+        BinaryInputArchive(std::istream& stream) :
+            InputArchive<BinaryInputArchive, cereal::AllowEmptyClassElision>(this),
+            stream(stream)
+        {
+
+        }
+
+        /*! Complete defered action if not completed. */
+        ~BinaryInputArchive()
+        {
+            complete();
+        }
+
+        /*! Loads pointer book-keeping and does defered pointer initialization.
+            @throws CRPSException If pointer-booking serialization or defered pointer initialization fails.
+        */
+        void complete()
+        {
+            if (completed) {
+                return;
+            }
+            completed = true;
+
+            serializeDeferments();
+
+            std::uint64_t count;
+            read(&count, sizeof(count));
+            detail::check_table_size(count, pointer_mapper.pointerCount());
+
+            std::vector<std::uint32_t> raw_to_obj(static_cast<std::size_t>(count));
+            read(raw_to_obj.data(), raw_to_obj.size() * sizeof(std::uint32_t));
+
+            pointer_mapper.completePointers(std::move(raw_to_obj));
+        }
+
+        /*! Resolves external object-ids saved by BinaryOutputArchive::setExternalObjects
+            against the objects of an external graph.
+
+            @param objects The ExternalObjects of the loaded external graph, which must outlive the archive
+            */
+        void setExternalObjects(ExternalObjects const& objects)
+        {
+            pointer_mapper.setExternalObjects(objects);
+        }
+
+        //! Only write pointers whose value changes, as the pointers are initialized by a previous load, set before the first serialization
+        void setInPlace(bool reload)
+        {
+            pointer_mapper.setInPlace(reload);
+        }
+
+        //! Throws a CRPSException from the serialization that makes the pointer book-keeping exceed limits
+        void setLimits(CRPSLimits const& limits)
+        {
+            pointer_mapper.setLimits(limits);
+        }
+
+        /*! Reads a block of bytes from the stream.
+            @throws CRPSException If called after complete, or if reading from the stream fails.
+        */
+        void loadBinary(void* data, std::size_t size)
+        {
+            if (completed) {
+                throw CRPSException("Attempted serialization after BinaryInputArchive::complete called");
+            }
+            read(data, size);
+        }
+
+        //! Serializes types, see handle
+        template <class ... Types> inline
+        BinaryInputArchive& operator()(Types&& ... args)
+        {
+            handle(std::forward<Types>(args)...);
+            return *this;
+        }
+
+        //! This is a boost compatability layer.
+        template <class T> inline
+        BinaryInputArchive& operator&(T&& arg)
+        {
+            handle(std::forward<T>(arg));
+            return *this;
+        }
+
+        //! This is a boost compatability layer.
+        template <class T> inline
+        BinaryInputArchive& operator>>(T&& arg)
+        {
+            handle(std::forward<T>(arg));
+            return *this;
+        }
+
+        //! Associate the object id to the object memory address.
+        template <class T> inline
+        void trackAddress(T& t)
+        {
+            pointer_mapper.trackAddress(t);
+        }
+
+        //! Associate the pointer id to the pointer's memory address, and track it as an object
+        template <class T> inline
+        void trackPointer(T*& p)
+        {
+            pointer_mapper.trackPointer(p);
+        }
+
+        //! Associate each of count elements of stride bytes, starting at data, with the next object id
+        void trackRange(void* data, std::size_t stride, std::size_t count)
+        {
+            pointer_mapper.trackRange(data, stride, count);
+        }
+
+    private:
+
+        /*! Serializes types as the cereal archive does.
+            A failed serialization, as when the limits are exceeded or the user serialization
+            or the stream fails, leaves the archive completed, so that ~BinaryInputArchive does not
+            load book-keeping for a partial traversal.
+            @throws CRPSException If attempted serialization after BinaryInputArchive::complete called.
+        */
+        template <class ... Types> inline
+        void handle(Types&& ... args)
+        {
+            if (completed) {
+                throw CRPSException("Attempted serialization after BinaryInputArchive::complete called");
+            }
+
+            try {
+                InputArchive<BinaryInputArchive, cereal::AllowEmptyClassElision>::operator()(std::forward<Types>(args)...);
+            }
+            catch (...) {
+                completed = true;
+                throw;
+            }
+        }
+
+        /*! Reads bytes from the stream.
+            @throws CRPSException If fewer bytes are read. */
+        void read(void* data, std::size_t size)
+        {
+            if (size == 0) {
+                return;
+            }
+            const std::streamsize readSize = stream.rdbuf()->sgetn(static_cast<char*>(data), static_cast<std::streamsize>(size));
+            if (readSize != static_cast<std::streamsize>(size)) {
+                throw CRPSException("Failed to read " + std::to_string(size) + " bytes from input stream! Read " + std::to_string(readSize));
+            }
+        }
+
+    private:
+        std::istream& stream; //!< User provided input stream
+
+        CRPSInputMapper pointer_mapper; //!< Object and pointer tables, filled by this archive's traversal
+
+        bool completed{ false }; //!< True if defered pointer initialization is completed
+    };
+
+    //! Save arithmetic types and track their memory address
+    template <class T> inline
+    typename std::enable_if<std::is_arithmetic<T>::value, void>::type
+    CEREAL_SAVE_FUNCTION_NAME(BinaryOutputArchive& ar, T const& t)
+    {
+        ar.saveBinary(std::addressof(t), sizeof(t));
+        ar.trackAddress(t);
+    }
+
+    //! Load arithmetic types and track their memory address
+    template <class T> inline
+    typename std::enable_if<std::is_arithmetic<T>::value, void>::type
+    CEREAL_LOAD_FUNCTION_NAME(BinaryInputArchive& ar, T& t)
+    {
+        ar.loadBinary(std::addressof(t), sizeof(t));
+        ar.trackAddress(t);
+    }
+
+    //! Track memory address of class types for defered saving of pointer associations
+    template<class T> inline
+    void CEREAL_SAVE_FUNCTION_NAME(BinaryOutputArchive& ar, PtrWrapper<ThisPointer<T>&> const& t)
+    {
+        ar.trackAddress(t.ptr.ref);
+    }
+
+    //! Track memory address of class types for defered loading of pointer associations
+    template<class T> inline
+    void CEREAL_SAVE_FUNCTION_NAME(BinaryInputArchive& ar, PtrWrapper<ThisPointer<T>&> const& t)
+    {
+        ar.trackAddress(t.ptr.ref);
+    }
+
+    //! Track initialized pointer's value for defered saving of pointer associations
+    template <class T> inline
+    void CEREAL_SAVE_FUNCTION_NAME(BinaryOutputArchive& ar, PtrWrapper<T*&> const& rpw)
+    {
+        ar.trackPointer(rpw.ptr);
+    }
+
+    //! Track uninitialized pointer's memory address for defered pointer initialization
+    template <class T> inline
+    void CEREAL_SAVE_FUNCTION_NAME(BinaryInputArchive& ar, PtrWrapper<T*&> const& rpw)
+    {
+        ar.trackPointer(rpw.ptr);
+    }
+
+    //! Save the elements of a blit array as one block, and track them as a range of memory
+    template <class T, class A> inline
+    void CEREAL_SAVE_FUNCTION_NAME(BinaryOutputArchive& ar, PtrWrapper<BlitArray<T, A>&> const& t)
+    {
+        std::vector<T, A>& vector = t.ptr.vector;
+        const cereal::size_type size = static_cast<cereal::size_type>(vector.size());
+
+        ar.saveBinary(&size, sizeof(size));
+        ar.saveBinary(vector.data(), vector.size() * sizeof(T));
+        ar.trackRange(vector.data(), sizeof(T), vector.size());
+    }
+
+    //! Load the elements of a blit array as one block, and track them as a range of memory
+    template <class T, class A> inline
+    void CEREAL_SAVE_FUNCTION_NAME(BinaryInputArchive& ar, PtrWrapper<BlitArray<T, A>&> const& t)
+    {
+        std::vector<T, A>& vector = t.ptr.vector;
+        cereal::size_type size;
+
+        ar.loadBinary(&size, sizeof(size));
+        vector.resize(static_cast<std::size_t>(size));
+        ar.loadBinary(vector.data(), vector.size() * sizeof(T));
+        ar.trackRange(vector.data(), sizeof(T), vector.size());
+    }
+
+    //! Save the object of a placed_ptr as a std::unique_ptr
+    template <class T> inline
+    void CEREAL_SAVE_FUNCTION_NAME(BinaryOutputArchive& ar, PtrWrapper<PlacedPointer<T>&> const& t)
+    {
+        ar(static_cast<placed_ptr<T> const&>(t.ptr.ptr));
+    }
+
+    //! Load the object of a placed_ptr as a std::unique_ptr, placement is not supported by BinaryInputArchive
+    template <class T> inline
+    void CEREAL_SAVE_FUNCTION_NAME(BinaryInputArchive& ar, PtrWrapper<PlacedPointer<T>&> const& t)
+    {
+        ar(t.ptr.ptr);
+    }
+
+    //! Unwrap NameValuePair, names are not saved
+    template <class Archive, class T> inline
+    CEREAL_ARCHIVE_RESTRICT(BinaryInputArchive, BinaryOutputArchive)
+    CEREAL_SERIALIZE_FUNCTION_NAME(Archive& ar, cereal::NameValuePair<T>& t)
+    {
+        ar(t.value);
+    }
+
+    //! Serialize the size of SizeTag, which is tracked like any other value
+    template <class Archive, class T> inline
+    CEREAL_ARCHIVE_RESTRICT(BinaryInputArchive, BinaryOutputArchive)
+    CEREAL_SERIALIZE_FUNCTION_NAME(Archive& ar, cereal::SizeTag<T>& t)
+    {
+        ar(t.size);
+    }
+
+    //! Save binary data as one block, without tracking
+    template <class T> inline
+    void CEREAL_SAVE_FUNCTION_NAME(BinaryOutputArchive& ar, cereal::BinaryData<T> const& bd)
+    {
+        ar.saveBinary(bd.data, static_cast<std::size_t>(bd.size));
+    }
+
+    //! Load binary data as one block, without tracking
+    template <class T> inline
+    void CEREAL_LOAD_FUNCTION_NAME(BinaryInputArchive& ar, cereal::BinaryData<T>& bd)
+    {
+        ar.loadBinary(bd.data, static_cast<std::size_t>(bd.size));
+    }
+}
+}
+
+CEREAL_REGISTER_ARCHIVE(crps::BinaryOutputArchive)
+CEREAL_REGISTER_ARCHIVE(crps::BinaryInputArchive)
+
+CEREAL_SETUP_ARCHIVE_TRAITS(crps::BinaryInputArchive, crps::BinaryOutputArchive)
+
+#endif
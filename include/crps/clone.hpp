@@ -0,0 +1,246 @@
+#ifndef CRPS_CLONE_HPP_
+#define CRPS_CLONE_HPP_
+
+#include "crps/crps.hpp"
+#include <cstring>
+
+namespace crps
+{
+inline namespace CRPS_TRACE_NAMESPACE
+{
+    namespace detail
+    {
+        //! A binary block of the source graph, referenced in place by CRPSCloneSource
+        struct CloneBlock
+        {
+            const void* data;       //!< Address of the binary block in the source graph
+            std::uint64_t size;     //!< Size in bytes of the binary block
+            std::size_t offset;     //!< Size in bytes of the scalars copied before the binary block
+        };
+    }
+
+    // ######################################################################
+    //! Records the values of a source graph for CRPSCloneDestination.
+    /*! This class takes the place of the user archive when cloning. Scalars
+        are packed back to back in their native representation, and binary
+        blocks are referenced in place, so the source graph must stay alive
+        until the destination traversal is done. No encoding is performed, and
+        binary blocks are not copied to a buffer.
+
+        @internal */
+    class CRPSCloneSource : public cereal::OutputArchive<CRPSCloneSource, cereal::AllowEmptyClassElision>
+    {
+    public:
+
+        CRPSCloneSource() :
+            OutputArchive<CRPSCloneSource, cereal::AllowEmptyClassElision>(this)
+        {
+
+        }
+
+        //! Copy a scalar value of the traversal
+        template <class T> inline
+        void saveValue(T const& t)
+        {
+            const std::size_t offset = cloned_scalars.size();
+            cloned_scalars.resize(offset + sizeof(T));
+            std::memcpy(cloned_scalars.data() + offset, std::addressof(t), sizeof(T));
+        }
+
+        //! Reference a binary block of the source graph
+        void saveBinary(const void* data, std::uint64_t size)
+        {
+            cloned_blocks.push_back(detail::CloneBlock{ data, size, cloned_scalars.size() });
+        }
+
+        //! Scalars visited by the traversal, packed in traversal order
+        std::vector<unsigned char> const& scalars() const
+        {
+            return cloned_scalars;
+        }
+
+        //! Binary blocks visited by the traversal, in traversal order
+        std::vector<detail::CloneBlock> const& blocks() const
+        {
+            return cloned_blocks;
+        }
+
+    private:
+        std::vector<unsigned char> cloned_scalars{};        //!< Scalars visited by the traversal, packed in traversal order
+        std::vector<detail::CloneBlock> cloned_blocks{};    //!< Binary blocks visited by the traversal, in traversal order
+    };
+
+    // ######################################################################
+    //! Initializes a destination graph from the values recorded by CRPSCloneSource.
+    /*! This class takes the place of the user archive when cloning. Scalars
+        are copied from the packed scalars of the source traversal, and binary
+        blocks directly from the source graph, in traversal order. Each value
+        must have the size and position it had in the source traversal.
+
+        @internal */
+    class CRPSCloneDestination : public cereal::InputArchive<CRPSCloneDestination, cereal::AllowEmptyClassElision>
+    {
+    public:
+
+        /*! @param source The values recorded by CRPSCloneSource from the source graph */
+        CRPSCloneDestination(CRPSCloneSource const& source) :
+            InputArchive<CRPSCloneDestination, cereal::AllowEmptyClassElision>(this),
+            cloned_scalars(source.scalars()),
+            cloned_blocks(source.blocks())
+        {
+
+        }
+
+        /*! Copy the next scalar value of the source traversal
+            @throws CRPSException If the source traversal saved fewer scalar bytes, or a binary block, at this position.
+        */
+        template <class T> inline
+        void loadValue(T& t)
+        {
+            if (cloned_scalars.size() - scalar_position < sizeof(T)) {
+                throw CRPSException("Clone destination traversal visited more values than the source traversal");
+            }
+            if (block_position != cloned_blocks.size() && cloned_blocks[block_position].offset < scalar_position + sizeof(T)) {
+                throw CRPSException("Clone destination traversal loaded a scalar where the source traversal saved binary data");
+            }
+            std::memcpy(std::addressof(t), cloned_scalars.data() + scalar_position, sizeof(T));
+            scalar_position += sizeof(T);
+        }
+
+        /*! Copy the next binary block of the source traversal
+            @throws CRPSException If the source traversal did not save a binary block of this size at this position.
+        */
+        void loadBinary(void* data, std::uint64_t size)
+        {
+            if (block_position == cloned_blocks.size()) {
+                throw CRPSException("Clone destination traversal visited more values than the source traversal");
+            }
+            detail::CloneBlock const& block = cloned_blocks[block_position];
+
+            if (block.offset != scalar_position) {
+                throw CRPSException("Clone destination traversal loaded binary data where the source traversal saved a scalar");
+            }
+            if (block.size != size) {
+                throw CRPSException("Clone destination traversal does not match the source traversal");
+            }
+            if (size != 0) {
+                std::memcpy(data, block.data, static_cast<std::size_t>(size));
+            }
+            block_position++;
+        }
+
+        //! True if every value recorded from the source traversal has been loaded
+        bool finished() const
+        {
+            return scalar_position == cloned_scalars.size() && block_position == cloned_blocks.size();
+        }
+
+    private:
+        std::vector<unsigned char> const& cloned_scalars;       //!< Scalars visited by the source traversal, packed
+        std::vector<detail::CloneBlock> const& cloned_blocks;   //!< Binary blocks visited by the source traversal
+
+        std::size_t scalar_position{};  //!< Offset of the next scalar to be loaded
+        std::size_t block_position{};   //!< Index of the next binary block to be loaded
+    };
+
+    //! Copy arithmetic types to the clone
+    template <class T> inline
+    typename std::enable_if<std::is_arithmetic<T>::value, void>::type
+    CEREAL_SAVE_FUNCTION_NAME(CRPSCloneSource& ar, T const& t)
+    {
+        ar.saveValue(t);
+    }
+
+    //! Copy arithmetic types from the source graph
+    template <class T> inline
+    typename std::enable_if<std::is_arithmetic<T>::value, void>::type
+    CEREAL_LOAD_FUNCTION_NAME(CRPSCloneDestination& ar, T& t)
+    {
+        ar.loadValue(t);
+    }
+
+    //! Unwrap NameValuePair, names are not used by the clone
+    template <class Archive, class T> inline
+    CEREAL_ARCHIVE_RESTRICT(CRPSCloneDestination, CRPSCloneSource)
+    CEREAL_SERIALIZE_FUNCTION_NAME(Archive& ar, cereal::NameValuePair<T>& t)
+    {
+        ar(t.value);
+    }
+
+    //! Unwrap SizeTag, the size is cloned as a scalar
+    template <class Archive, class T> inline
+    CEREAL_ARCHIVE_RESTRICT(CRPSCloneDestination, CRPSCloneSource)
+    CEREAL_SERIALIZE_FUNCTION_NAME(Archive& ar, cereal::SizeTag<T>& t)
+    {
+        ar(t.size);
+    }
+
+    //! Reference binary data of the source graph
+    template <class T> inline
+    void CEREAL_SAVE_FUNCTION_NAME(CRPSCloneSource& ar, cereal::BinaryData<T> const& bd)
+    {
+        ar.saveBinary(bd.data, static_cast<std::uint64_t>(bd.size));
+    }
+
+    //! Copy binary data from the source graph
+    template <class T> inline
+    void CEREAL_LOAD_FUNCTION_NAME(CRPSCloneDestination& ar, cereal::BinaryData<T>& bd)
+    {
+        ar.loadBinary(bd.data, static_cast<std::uint64_t>(bd.size));
+    }
+
+    // ######################################################################
+    //! Deep-clones an object graph that contains raw pointers.
+    /*! Produces the same graph as saving source through a CRPSOutputArchive
+        and loading it into destination through a CRPSInputArchive, without
+        encoding to or decoding from a stream. Values are copied directly from
+        the source graph, and the pointer-id to object-id map created by
+        CRPSOutputMapper is handed to CRPSInputMapper in memory.
+
+        The clone is made in place, as pointers into destination itself
+        would not survive returning it by value.
+
+        Example:
+        @code{cpp}
+        std::vector<Edge> edges_copy;
+        crps::clone(edges, edges_copy);
+        @endcode
+
+        @throws CRPSException If a pointer does not point to an object of the source graph,
+                              or if destination is not traversed like source.
+        @ingroup Utility
+        */
+    template <class T> inline
+    void clone(T const& source, T& destination)
+    {
+        CRPSCloneSource source_archive{};
+        CRPSOutputMapper source_mapper{};
+
+        source_archive(source);
+        source_archive.serializeDeferments();
+        source_mapper(source);
+        source_mapper.serializeDeferments();
+
+        CRPSCloneDestination destination_archive(source_archive);
+        CRPSInputMapper destination_mapper{};
+
+        destination_archive(destination);
+        destination_archive.serializeDeferments();
+        destination_mapper(destination);
+        destination_mapper.serializeDeferments();
+
+        if (!destination_archive.finished()) {
+            throw CRPSException("Clone destination traversal visited fewer values than the source traversal");
+        }
+
+        destination_mapper.restorePointers(source_mapper.pointerTable());
+    }
+}
+}
+
+CEREAL_REGISTER_ARCHIVE(crps::CRPSCloneSource)
+CEREAL_REGISTER_ARCHIVE(crps::CRPSCloneDestination)
+
+CEREAL_SETUP_ARCHIVE_TRAITS(crps::CRPSCloneDestination, crps::CRPSCloneSource)
+
+#endif
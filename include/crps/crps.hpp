@@ -4,7 +4,31 @@
 #include "cereal/cereal.hpp"
 #include "cereal/types/memory.hpp"
 #include "cereal/types/vector.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <new>
+#include <numeric>
 #include <sstream>
+#include <thread>
+#include <tuple>
+
+namespace cereal
+{
+    class JSONOutputArchive;
+    class JSONInputArchive;
+    class XMLOutputArchive;
+    class XMLInputArchive;
+}
 
 namespace crps 
 {
@@ -16,9 +40,216 @@ namespace crps
         using std::runtime_error::runtime_error;
     };
 
+    // ######################################################################
+    //! Limits on the pointer book-keeping of a traversal
+    /*! A traversal that exceeds a limit throws a CRPSException as soon as the
+        limit is exceeded, instead of growing the book-keeping until memory is
+        exhausted. The byte limit applies to an estimate of the memory held by
+        the object and pointer tables, not to the objects being serialized.
+        Every limit is unbounded by default.
+
+        @code{cpp}
+        crps::CRPSLimits limits;
+        limits.max_objects = 1 << 24;
+        limits.max_bytes = 512 << 20;
+        crps_iarchive.setLimits(limits);
+        @endcode
+
+        @ingroup Utility */
+    struct CRPSLimits
+    {
+        std::size_t max_objects = std::numeric_limits<std::size_t>::max();   //!< Tracked objects, a blit array counts as one object
+        std::size_t max_pointers = std::numeric_limits<std::size_t>::max();  //!< Tracked pointers
+        std::size_t max_bytes = std::numeric_limits<std::size_t>::max();     //!< Estimated bytes of the object and pointer tables
+    };
+
+    // ######################################################################
+    //! Index used by CRPSOutputMapper for objects that are not coalesced into address runs
+    /*! @ingroup Utility */
+    enum class CRPSBackend
+    {
+        Automatic,  //!< Chosen by sampling the first objects and pointers of the traversal
+        Hash,       //!< Hash map from address to object-id, suited to graphs with many pointers per object
+        SortedLog   //!< Log of addresses and object-ids, sorted once before pointers are resolved, suited to sparse pointers
+    };
+
+    // ######################################################################
+    //! Statistics of the pointer book-keeping of a save
+    /*! @ingroup Utility */
+    struct CRPSMapperStats
+    {
+        CRPSBackend backend;            //!< Index of the objects outside of address runs, Hash or SortedLog
+        bool automatic;                 //!< True if backend was chosen by sampling, rather than by setBackend
+        bool spilled;                   //!< True if the book-keeping is spilled to temporary files, see setSpillBudget
+        std::size_t objects;            //!< Tracked objects, including those of spliced fragments
+        std::size_t pointers;           //!< Tracked pointers, since the last release of pointers
+        std::size_t table_entries;      //!< Objects stored one by one in the backend
+        std::size_t address_runs;       //!< Runs of equally spaced objects, stored compactly
+    };
+
+    // ######################################################################
+    //! A phase of a save or load, reported to a CRPSTraceSink
+    /*! @ingroup Utility */
+    struct CRPSTraceEvent
+    {
+        const char* name;                                   //!< Name of the phase, such as "mapper" or "fixup"
+        std::chrono::steady_clock::time_point begin;        //!< Time the phase began
+        std::chrono::steady_clock::time_point end;          //!< Time the phase ended
+        std::size_t objects;                                //!< Objects tracked when the phase ended, if counted
+        std::size_t pointers;                               //!< Pointers tracked when the phase ended, if counted
+        bool counted;                                       //!< True if objects and pointers are set
+    };
+
+    // ######################################################################
+    //! Receives the phases of saves and loads, when compiled with CRPS_ENABLE_TRACE
+    /*! Trace events are only emitted by archives compiled with CRPS_ENABLE_TRACE
+        defined before crps.hpp is included, and only while a sink is set. Without
+        CRPS_ENABLE_TRACE the trace hooks compile to nothing, and with it each
+        phase costs one atomic load while no sink is set. The archives are
+        declared in the inline namespace crps::trace_on or crps::trace_off by the
+        macro, so translation units compiled with and without it link distinct
+        symbols, and share the sink set by set_trace_sink.
+        The phases are the user archive and mapper passes of each serialization,
+        the serialization of deferments, the generation, saving and loading of
+        the pointer book-keeping, and the fixup of loaded pointers.
+
+        Events are reported on the thread that ran the phase, which is a worker
+        thread for complete_async, so a sink must be thread safe. A sink must not
+        throw, as events are reported when a phase is left by an exception too.
+
+        @code{cpp}
+        #define CRPS_ENABLE_TRACE
+        #include <crps/trace.hpp>
+
+        crps::ChromeTraceSink sink("crps_trace.json");
+        crps::set_trace_sink(&sink);
+        @endcode
+
+        @ingroup Utility */
+    class CRPSTraceSink
+    {
+    public:
+        virtual ~CRPSTraceSink() = default;
+
+        //! Called once for each phase, when the phase ends
+        virtual void event(CRPSTraceEvent const& event) = 0;
+
+        //! Sink of the trace events of every archive, null if events are discarded
+        static std::atomic<CRPSTraceSink*>& current()
+        {
+            static std::atomic<CRPSTraceSink*> sink{ nullptr };
+            return sink;
+        }
+    };
+
+    /*! Sets the sink of the trace events of every archive, or discards events if sink is null. 
+        Has no effect on archives compiled without CRPS_ENABLE_TRACE. The sink must outlive 
+        the archives that use it. 
+        @ingroup Utility */
+    inline void set_trace_sink(CRPSTraceSink* sink)
+    {
+        CRPSTraceSink::current().store(sink, std::memory_order_release);
+    }
+}
+
+//! Inline namespace of the archives, which tells apart the symbols of translation units compiled with and without CRPS_ENABLE_TRACE
+#ifdef CRPS_ENABLE_TRACE
+#define CRPS_TRACE_NAMESPACE trace_on
+#else
+#define CRPS_TRACE_NAMESPACE trace_off
+#endif
+
+namespace crps
+{
+inline namespace CRPS_TRACE_NAMESPACE
+{
+#ifdef CRPS_ENABLE_TRACE
+    namespace detail
+    {
+        //! Reports the phase of its scope to the trace sink, used through CRPS_TRACE_SCOPE
+        class TraceScope
+        {
+        public:
+            explicit TraceScope(const char* name) : sink(CRPSTraceSink::current().load(std::memory_order_acquire)), name(name)
+            {
+                if (sink != nullptr) {
+                    begin = std::chrono::steady_clock::now();
+                }
+            }
+
+            TraceScope(TraceScope const&) = delete;
+            TraceScope& operator=(TraceScope const&) = delete;
+
+            ~TraceScope()
+            {
+                if (sink != nullptr) {
+                    sink->event(CRPSTraceEvent{ name, begin, std::chrono::steady_clock::now(), objects, pointers, counted });
+                }
+            }
+
+            //! True if the phase is reported
+            bool active() const
+            {
+                return sink != nullptr;
+            }
+
+            //! Attaches the objects and pointers tracked at the end of the phase
+            void setCounts(std::size_t object_count, std::size_t pointer_count)
+            {
+                objects = object_count;
+                pointers = pointer_count;
+                counted = true;
+            }
+
+            //! Attaches the objects and pointers of the stats of a mapper
+            void setCounts(CRPSMapperStats const& stats)
+            {
+                setCounts(stats.objects, stats.pointers);
+            }
+
+        private:
+            CRPSTraceSink* sink;                                //!< Sink when the phase began
+            const char* name;                                   //!< Name of the phase
+            std::chrono::steady_clock::time_point begin{};      //!< Time the phase began
+            std::size_t objects{ 0 };                           //!< Objects tracked, if counted
+            std::size_t pointers{ 0 };                          //!< Pointers tracked, if counted
+            bool counted{ false };                              //!< True if setCounts was called
+        };
+    }
+
+    //! Reports the rest of the enclosing scope as a phase named name, if a trace sink is set
+    #define CRPS_TRACE_SCOPE(name) ::crps::detail::TraceScope crps_trace_scope(name)
+    //! Attaches object and pointer counts to the phase of CRPS_TRACE_SCOPE, evaluated only if it is reported
+    #define CRPS_TRACE_COUNTS(objects, pointers) if (crps_trace_scope.active()) { crps_trace_scope.setCounts(objects, pointers); }
+    //! Attaches the object and pointer counts of CRPSMapperStats to the phase of CRPS_TRACE_SCOPE, evaluated once and only if it is reported
+    #define CRPS_TRACE_STATS(stats) if (crps_trace_scope.active()) { crps_trace_scope.setCounts(stats); }
+#else
+    #define CRPS_TRACE_SCOPE(name)
+    #define CRPS_TRACE_COUNTS(objects, pointers)
+    #define CRPS_TRACE_STATS(stats)
+#endif
+
     namespace detail 
     {
         class CRPSMapperCore {}; //!< Traits struct for CRPSOutputMapper and CRPSInputMapper
+
+        template <std::size_t ... I>
+        struct index_sequence {}; //!< C++11 replacement for std::index_sequence
+
+        template <std::size_t N, std::size_t ... I>
+        struct make_index_sequence : make_index_sequence<N - 1, N - 1, I...> {};
+
+        template <std::size_t ... I>
+        struct make_index_sequence<0, I...> : index_sequence<I...> {};
+
+        template <bool ... B>
+        struct bool_pack {};
+
+        //! True if every value of B is true
+        template <bool ... B>
+        using all_of = std::is_same<bool_pack<true, B...>, bool_pack<B..., true>>;
+
+        using swallow = int[]; //!< Evaluates a pack expansion in order
     }
 
     template <typename T>
@@ -179,345 +410,3338 @@ namespace crps
         }
     };
 
+    //! Saves and loads a pointer wrapper without a node in a text archive, as it has no representation in user archives
+#define CRPS_NO_TEXT_NODE(TextArchive, Wrapper)                                 \
+    template <class T> inline void prologue(TextArchive&, Wrapper<T> const&) {} \
+    template <class T> inline void epilogue(TextArchive&, Wrapper<T> const&) {}
 
-    // forward decls
-    class CRPSInputMapper;
-    class CRPSOutputMapper;
+#define CRPS_NO_TEXT_NODES(TextArchive)             \
+    CRPS_NO_TEXT_NODE(TextArchive, RawPointer)      \
+    CRPS_NO_TEXT_NODE(TextArchive, ThisPointer)     \
+    CRPS_NO_TEXT_NODE(TextArchive, raw_ptr)
 
-    // ######################################################################
-    //! A wrapper that enables serializing raw pointers for output archives.    
-    /*! This class enables an archive to be used to serialize raw pointers 
-        that point to types co-serialized by the graph traversal. It provides 
-        an archive interface that wraps the interface of the provided user archive, 
-        to intercept objects and store their memory addresses.  
+    CRPS_NO_TEXT_NODES(cereal::JSONOutputArchive)
+    CRPS_NO_TEXT_NODES(cereal::JSONInputArchive)
+    CRPS_NO_TEXT_NODES(cereal::XMLOutputArchive)
+    CRPS_NO_TEXT_NODES(cereal::XMLInputArchive)
 
-        Upon ~CRPSOutputArchive or CRPSOutputArchive::complete, 
-        a vector used for mapping pointer indexes to object traversal indexes 
-        is passed into the user provided archive to be serialized. An exception 
-        is thrown if serialization is attempted after CRPSOutputArchive::complete. 
-         
-        Tracking addresses of BinaryData is not currently supported. 
+#undef CRPS_NO_TEXT_NODES
+#undef CRPS_NO_TEXT_NODE
 
-        @endcode */
-    template<class Archive>
-    class CRPSOutputArchive
+
+    // ######################################################################
+    //! An archivable wrapper that loads smart pointers into their existing objects.
+    /*! Saved like the wrapped std::shared_ptr or std::unique_ptr. When loaded, 
+        an existing object of the smart pointer is loaded in place, instead of 
+        being replaced by a newly constructed object. This keeps the memory 
+        addresses of a graph stable when reloading into an identically shaped 
+        graph, so that external pointers into the graph remain valid. 
+        A new object is only constructed if the smart pointer is empty. 
+
+        Polymorphic types are not supported. 
+        @internal */
+    template<class Ptr>
+    class InPlacePointer
     {
     public:
 
-        /*! @param archive The archive provided by the user, its interface is wrapped for object tracking. */
-        CRPSOutputArchive(Archive& archive) : archive(archive)
-        {
-            static_assert(Archive::is_saving::value, "CRPSOutputArchive<Archive> cannot be used with an input archive.");
-        }
+        InPlacePointer(Ptr& ptr) : ptr(ptr) {}
 
-        /*! Complete defered action if not completed. */
-        ~CRPSOutputArchive()
+        Ptr& ptr;
+
+        //! Save as the smart pointer itself, for output archives and the crps mappers
+        template<class Archive> inline
+        void CEREAL_SAVE_FUNCTION_NAME(Archive& ar) const
         {
-            complete();
+            ar(CEREAL_NVP_("ptr_wrapper", cereal::memory_detail::make_ptr_wrapper(static_cast<Ptr const&>(ptr))));
         }
 
-        /*! For OutputArchive: generates pointer book-keeping and saves book-keeping to output_archive, 
-            For InputArchive: loads book-keeping from input_archive and does defered pointer initialization. 
-
-            @throws CRPSException If pointer-booking serialization or defered pointer initialization fails. 
-        */
-        void complete()
+        //! Load into the existing object of the smart pointer
+        template<class Archive> inline
+        void CEREAL_LOAD_FUNCTION_NAME(Archive& ar)
         {
-            if (completed) {
-                return;
-            }
-            completed = true;
+            static_assert(!std::is_polymorphic<typename Ptr::element_type>::value, "crps::in_place does not support polymorphic types");
 
-            archive.serializeDeferments();
-            pointer_mapper.complete(archive);
+            Loader loader{ ptr };
+            ar(CEREAL_NVP_("ptr_wrapper", loader));
         }
 
-        //! Forwards types to user archive and crps mapper. 
-        template <class ... Types> inline
-        CRPSOutputArchive& operator()(Types&& ... args)
-        {
-            handle(std::forward<Types>(args)...);
-            return *this;
-        }
+    private:
 
-        //! This is a boost compatability layer.
-        template <class T> inline
-        CRPSOutputArchive& operator&(T&& arg)
+        //! Loads the contents of cereal's ptr_wrapper for the smart pointer
+        struct Loader
         {
-            handle(std::forward<T>(arg));
-            return *this;
-        }
+            Ptr& ptr;
 
-        //! This is a boost compatability layer.
-        template <class T> inline
-        CRPSOutputArchive& operator<<(T&& arg)
-        {
-            handle(std::forward<T>(arg));
-            return *this;
-        }
+            template<class Archive, class T> inline
+            void loadInPlace(Archive& ar, std::shared_ptr<T>& shared)
+            {
+                std::uint32_t id;
+                ar(CEREAL_NVP_("id", id));
 
-    private:
+                if (id & cereal::detail::msb_32bit)
+                {
+                    if (!shared) {
+                        shared = std::make_shared<T>();
+                    }
+                    ar.registerSharedPointer(id, shared);
+                    ar(CEREAL_NVP_("data", *shared));
+                }
+                else {
+                    shared = std::static_pointer_cast<T>(ar.getSharedPointer(id));
+                }
+            }
 
-        /*! Forwards user archive and crps mapper with types. 
-            @throws CRPSException If attempted serialization afterCRPSArchiveBase::complete called. 
-        */
-        template <class ... Types> inline
-        void handle(Types&& ... args)
-        {
-            if (completed) {
-                throw CRPSException("Attempted serialization after CRPSArchiveBase::complete called");
+            template<class Archive, class T, class D> inline
+            void loadInPlace(Archive& ar, std::unique_ptr<T, D>& unique)
+            {
+                std::uint8_t valid;
+                ar(CEREAL_NVP_("valid", valid));
+
+                if (valid)
+                {
+                    if (!unique) {
+                        unique.reset(new T());
+                    }
+                    ar(CEREAL_NVP_("data", *unique));
+                }
+                else {
+                    unique.reset();
+                }
             }
 
-            archive(std::forward<Types>(args)...);
-            pointer_mapper(std::forward<Types>(args)...);
-        }
+            template<class Archive> inline
+            void CEREAL_LOAD_FUNCTION_NAME(Archive& ar)
+            {
+                loadInPlace(ar, ptr);
+            }
+        };
+    };
 
-    private:
-        Archive& archive; //!< User provided serialization archive
+    //! Creates an InPlacePointer for a std::shared_ptr
+    /*! Example: 
+        @code{cpp}
+        struct Scene
+        {
+            std::shared_ptr<Mesh> mesh;
 
-        CRPSOutputMapper pointer_mapper; //!< type is CRPSOutputMapper if Archive::is_saving, otherwise CRPSInputMapper
+            template<class Archive>
+            void serialize(Archive& ar)
+            {
+                ar(crps::in_place(mesh));
+            }
+        };
+        @endcode
 
-        bool completed{ false }; //!< True if CRPSOutputMapper or CRPSInputMapper complete method has been called
-    };
-    
-    // ###################################################################### 
-    //! A wrapper that enables serializing raw pointers for output archives.
-    /*! This class enables an archive to be used to serialize raw pointers 
-        that point to types co-serialized by the graph traversal. It provides 
-        an archive interface that wraps the interface of the provided user archive, 
-        to intercept objects and store their memory addresses. 
+        @relates InPlacePointer
+        @ingroup Utility 
+        */
+    template <class T> inline
+    InPlacePointer<std::shared_ptr<T>> in_place(std::shared_ptr<T>& ptr)
+    {
+        return { ptr };
+    }
 
-        Upon ~CRPSInputArchive or CRPSInputArchive::complete, 
-        a vector used for mapping pointer indexes to object traversal indexes 
-        is loaded from the user provided archive and is used to restore the 
-        association of pointers relative to object traversal indexes. An exception 
-        is thrown if serialization is attempted after CRPSInputArchive::complete. 
+    //! Creates an InPlacePointer for a std::unique_ptr
+    /*! Only std::default_delete is supported, as an empty std::unique_ptr is loaded 
+        into an object allocated with new. 
 
-        Tracking addresses of BinaryData is not currently supported.
+        @relates InPlacePointer
+        @ingroup Utility 
+        */
+    template <class T, class D> inline
+    InPlacePointer<std::unique_ptr<T, D>> in_place(std::unique_ptr<T, D>& ptr)
+    {
+        static_assert(std::is_same<D, std::default_delete<T>>::value, "crps::in_place only supports std::unique_ptr with std::default_delete");
+        return { ptr };
+    }
 
-        @endcode */
+    // ######################################################################
+    //! Contiguous storage for objects placed by CRPSInputArchive::setPlacement.
+    /*! Memory is allocated from blocks in the order objects are placed, and is 
+        released when the arena is destroyed. The objects themselves are destroyed 
+        by their placed_ptr, so the arena must outlive every placed_ptr it stores. 
 
-    template<class Archive>
-    class CRPSInputArchive
+        @ingroup Utility */
+    class PlacementArena
     {
     public:
 
-        /*! @param archive The archive provided by the user, its interface is wrapped for object tracking. */
-        CRPSInputArchive(Archive& archive) : archive(archive)
-        { 
-            static_assert(Archive::is_loading::value, "CRPSInputArchive<Archive> cannot be used with an output archive.");
-        }
-
-        /*! Complete defered action if not completed. */
-        ~CRPSInputArchive()
+        /*! @param block_size Bytes of each block, objects larger than a block get their own block */
+        PlacementArena(std::size_t block_size = 1 << 16) :
+            block_size(block_size)
         {
-            complete();
-        }
 
-        /*! For OutputArchive: generates pointer book-keeping and saves book-keeping to output_archive,
-            For InputArchive: loads book-keeping from input_archive and does defered pointer initialization.
+        }
 
-            @throws CRPSException If pointer-booking serialization or defered pointer initialization fails.
-        */
-        void complete()
+        //! Allocates bytes aligned to alignment, which must not exceed alignof(std::max_align_t)
+        void* allocate(std::size_t bytes, std::size_t alignment)
         {
-            if (completed) {
-                return;
+            std::size_t padding = (alignment - reinterpret_cast<std::uintptr_t>(position) % alignment) % alignment;
+            if (position == nullptr || padding + bytes > remaining)
+            {
+                const std::size_t size = std::max(bytes, block_size);
+                blocks.emplace_back(new char[size]);
+                const BlockRange range{ reinterpret_cast<std::uintptr_t>(blocks.back().get()), reinterpret_cast<std::uintptr_t>(blocks.back().get()) + size };
+                block_ranges.insert(std::upper_bound(block_ranges.begin(), block_ranges.end(), range), range);
+                position = blocks.back().get();
+                remaining = size;
+                padding = 0;
             }
-            completed = true;
-
-            archive.serializeDeferments();
-            pointer_mapper.complete(archive);
-        }
 
-        //! Forwards types to user archive and crps mapper. 
-        template <class ... Types> inline
-        CRPSInputArchive& operator()(Types&& ... args)
-        {
-            handle(std::forward<Types>(args)...);
-            return *this;
+            void* object = position + padding;
+            position += padding + bytes;
+            remaining -= padding + bytes;
+            allocated += bytes;
+            return object;
         }
 
-        //! This is a boost compatability layer.
-        template <class T> inline
-        CRPSInputArchive& operator&(T&& arg)
+        //! True if address is in storage allocated by the arena, found by a binary search of the blocks
+        bool contains(const void* address) const
         {
-            handle(std::forward<T>(arg));
-            return *this;
+            const BlockRange range{ reinterpret_cast<std::uintptr_t>(address), reinterpret_cast<std::uintptr_t>(address) };
+            auto block = std::upper_bound(block_ranges.begin(), block_ranges.end(), range);
+            return block != block_ranges.begin() && range.begin < (--block)->end;
         }
 
-        //! This is a boost compatability layer.
-        template <class T> inline
-        CRPSInputArchive& operator>>(T&& arg)
+        //! Bytes allocated for objects, excluding alignment padding and unused block space
+        std::size_t size() const
         {
-            handle(std::forward<T>(arg));
-            return *this;
+            return allocated;
         }
 
     private:
-
-        /*! Forwards user archive and crps mapper with types.
-            @throws CRPSException If attempted serialization afterCRPSArchiveBase::complete called.
-        */
-        template <class ... Types> inline
-        void handle(Types&& ... args)
+        //! Addresses of the storage of a block
+        struct BlockRange
         {
-            if (completed) {
-                throw CRPSException("Attempted serialization after CRPSArchiveBase::complete called");
+            std::uintptr_t begin;   //!< Address of the first byte
+            std::uintptr_t end;     //!< Address past the last byte
+
+            bool operator<(BlockRange const& other) const
+            {
+                return begin < other.begin;
             }
-            archive(std::forward<Types>(args)...);
-            pointer_mapper(std::forward<Types>(args)...);
-        }
+        };
 
-    private:
-        Archive& archive; //!< User provided serialization archive
+        std::vector<std::unique_ptr<char[]>> blocks{}; //!< Blocks of storage, in allocation order
 
-        CRPSInputMapper pointer_mapper; //!< type is CRPSOutputMapper if Archive::is_saving, otherwise CRPSInputMapper
+        std::vector<BlockRange> block_ranges{}; //!< Storage of each block, in ascending address order
+
+        char* position{ nullptr }; //!< Next free byte of the last block
+
+        std::size_t remaining{}; //!< Free bytes of the last block
+
+        std::size_t allocated{}; //!< Bytes allocated for objects
+
+        std::size_t block_size; //!< Bytes of each block
+    };
+
+    //! Deleter of placed_ptr, which only destroys objects stored in its PlacementArena
+    template <class T>
+    struct PlacementDeleter
+    {
+        PlacementDeleter() = default;
+
+        explicit PlacementDeleter(PlacementArena const* arena) : arena(arena) {}
+
+        //! Destroys ptr in place if it is stored in the arena, otherwise deletes it. Only placed_ptr set by a placement have an arena to search
+        void operator()(T* ptr) const
+        {
+            if (arena != nullptr && arena->contains(ptr)) {
+                ptr->~T();
+            }
+            else {
+                delete ptr;
+            }
+        }
+
+        PlacementArena const* arena{ nullptr }; //!< Arena of objects placed by CRPSInputArchive, objects outside of it were allocated with new
+    };
+
+    //! A std::unique_ptr whose object may be moved into a PlacementArena when loaded
+    template <class T>
+    using placed_ptr = std::unique_ptr<T, PlacementDeleter<T>>;
+
+    //! Order in which CRPSInputArchive places objects into a PlacementArena
+    enum class PlacementOrder
+    {
+        Traversal,      //!< Order of the serialization traversal
+        BreadthFirst    //!< Breadth-first from each object not owned by a placed object, along ownership and pointers
+    };
+
+    // ######################################################################
+    //! An archivable wrapper for placed_ptr, whose object may be placed into a PlacementArena.
+    /*! Saved and loaded like the wrapped std::unique_ptr. When loaded by a 
+        CRPSInputArchive with a PlacementArena set, the object is registered 
+        with the CRPSInputMapper, which moves it into the arena once the 
+        pointer book-keeping is loaded. 
+        @internal */
+    template<class T>
+    class PlacedPointer
+    {
+    public:
+
+        PlacedPointer(placed_ptr<T>& ptr) : ptr(ptr) {}
+
+        placed_ptr<T>& ptr;
+
+        //! Register the object for placement with CRPSInputMapper, and traverse it as a std::unique_ptr
+        template<class Archive> inline
+        typename std::enable_if<std::is_base_of<detail::CRPSMapperCore, Archive>::value, void>::type
+        CEREAL_SERIALIZE_FUNCTION_NAME(Archive& ar)
+        {
+            CEREAL_SAVE_FUNCTION_NAME(ar, cereal::memory_detail::PtrWrapper<PlacedPointer&>(*this));
+        }
+
+        //! Representation for the user archive, as the std::unique_ptr itself
+        template<class Archive> inline
+        typename std::enable_if<!std::is_base_of<detail::CRPSMapperCore, Archive>::value, void>::type
+        CEREAL_SERIALIZE_FUNCTION_NAME(Archive& ar)
+        {
+            ar(CEREAL_NVP_("ptr_wrapper", cereal::memory_detail::make_ptr_wrapper(pointer(typename Archive::is_saving()))));
+        }
+
+    private:
+
+        //! The smart pointer, as saved by output archives
+        placed_ptr<T> const& pointer(std::true_type) const
+        {
+            return ptr;
+        }
+
+        //! The smart pointer, as loaded by input archives
+        placed_ptr<T>& pointer(std::false_type)
+        {
+            return ptr;
+        }
+    };
+
+    //! Creates a PlacedPointer for a placed_ptr
+    /*! Example: 
+        @code{cpp}
+        struct Node
+        {
+            crps::placed_ptr<Node> left, right;
+            crps::raw_ptr<Node> parent;
+
+            template<class Archive>
+            void serialize(Archive& ar)
+            {
+                ar(crps::placed(left), crps::placed(right), parent, crps::this_ptr(this));
+            }
+        };
+        @endcode
+
+        @relates PlacedPointer
+        @ingroup Utility 
+        */
+    template <class T> inline
+    PlacedPointer<T> placed(placed_ptr<T>& ptr)
+    {
+        static_assert(!std::is_polymorphic<T>::value, "crps::placed does not support polymorphic types");
+        static_assert(std::is_move_constructible<T>::value, "crps::placed requires a move constructible type");
+        static_assert(alignof(T) <= alignof(std::max_align_t), "crps::placed does not support over-aligned types");
+        return { ptr };
+    }
+
+    namespace detail
+    {
+        //! True if T is a crps::raw_ptr
+        template <class T>
+        struct is_raw_ptr : std::false_type {};
+
+        template <class T>
+        struct is_raw_ptr<raw_ptr<T>> : std::true_type {};
+
+        //! Passes a wrapper to the save function of a crps mapper for it, found by ADL where a member save of the wrapper would hide it
+        template <class Archive, class Wrapper> inline
+        void track_wrapper(Archive& ar, Wrapper& wrapper)
+        {
+            CEREAL_SAVE_FUNCTION_NAME(ar, cereal::memory_detail::PtrWrapper<Wrapper&>(wrapper));
+        }
+    }
+
+    // ######################################################################
+    //! An archivable wrapper that saves a vector of trivially copyable types as one block.
+    /*! The user archive receives the size of the vector, followed by its 
+        elements as one block of binary data, instead of one call per member. 
+        The crps mappers track the elements as one range of memory with an 
+        object-id per element, so pointers to an element are resolved by their 
+        offset into the range. Members of the elements are not tracked one by 
+        one, so a pointer to a member is saved as the object-id of its element, 
+        flagged with detail::member_object_flag, and the offset of the member. 
+
+        The elements are copied byte by byte, so they must not contain pointers, 
+        including crps::raw_ptr members, which would be saved as addresses of 
+        the saving process. User archives must support cereal::BinaryData. 
+        @internal */
+    template<class T, class A>
+    class BlitArray
+    {
+    public:
+
+        BlitArray(std::vector<T, A>& vector) : vector(vector) {}
+
+        std::vector<T, A>& vector;
+
+        //! Register the elements as a range of memory with CRPSOutputMapper or CRPSInputMapper
+        template<class Archive> inline
+        typename std::enable_if<std::is_base_of<detail::CRPSMapperCore, Archive>::value, void>::type
+        CEREAL_SERIALIZE_FUNCTION_NAME(Archive& ar)
+        {
+            detail::track_wrapper(ar, *this);
+        }
+
+        //! Representation for the user archive, saved without modifying the vector, which the concurrent mapper may be reading
+        template<class Archive> inline
+        typename std::enable_if<!std::is_base_of<detail::CRPSMapperCore, Archive>::value, void>::type
+        CEREAL_SAVE_FUNCTION_NAME(Archive& ar) const
+        {
+            ar(cereal::make_size_tag(static_cast<cereal::size_type>(vector.size())));
+            ar(cereal::binary_data(vector.data(), vector.size() * sizeof(T)));
+        }
+
+        //! Representation for the user archive, loaded into the resized vector
+        template<class Archive> inline
+        typename std::enable_if<!std::is_base_of<detail::CRPSMapperCore, Archive>::value, void>::type
+        CEREAL_LOAD_FUNCTION_NAME(Archive& ar)
+        {
+            cereal::size_type size;
+            ar(cereal::make_size_tag(size));
+            vector.resize(static_cast<std::size_t>(size));
+            ar(cereal::binary_data(vector.data(), vector.size() * sizeof(T)));
+        }
+    };
+
+    //! Creates a BlitArray that saves and loads the elements of a vector as one block
+    /*! Example:
+        @code{cpp}
+        struct Mesh
+        {
+            std::vector<Vertex> vertices;
+
+            template<class Archive>
+            void serialize(Archive& ar)
+            {
+                ar(crps::blit(vertices));
+            }
+        };
+        @endcode
+
+        @relates BlitArray
+        @ingroup Utility
+        */
+    template <class T, class A> inline
+    BlitArray<T, A> blit(std::vector<T, A>& vector)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "crps::blit requires a trivially copyable type");
+        static_assert(!std::is_pointer<T>::value && !detail::is_raw_ptr<T>::value, "crps::blit does not support pointers, which must be tracked one by one");
+        return { vector };
+    }
+
+    namespace detail
+    {
+        static const std::uint32_t external_object_flag = 0x80000000; //!< Marks an external object-id in the pointer_id_to_object_id map
+        static const std::uint32_t member_object_flag = 0x40000000; //!< Marks the object-id of a blit array element containing the target of a pointer to a member of it
+
+        /*! Checks that count more object-ids, following the first count_before, stay below member_object_flag. 
+            @throws CRPSException If an object-id would reach member_object_flag. */
+        inline void check_object_ids(std::uint64_t count_before, std::uint64_t count)
+        {
+            if (count_before + count > member_object_flag) {
+                throw CRPSException("Object count exceeds the 2^30 object-ids available below the member object flag");
+            }
+        }
+
+        //! True if the pointer_id_to_object_id map entry is an internal object-id flagged with member_object_flag
+        inline bool is_member_object(std::uint32_t id)
+        {
+            return (id & (external_object_flag | member_object_flag)) == member_object_flag;
+        }
+
+        //! The target of a pointer to a member of a blit array element, loaded by CRPSInputMapper
+        struct MemberTarget
+        {
+            std::uint32_t id;           //!< Object-id of the element
+            std::uint32_t offset;       //!< Offset in bytes of the member in the element
+        };
+
+        //! Assigns an object address to a pointer, with the type the pointer was tracked with
+        using PointerAssign = void (*)(void* raw, void* obj_address);
+
+        //! Assigns obj_address to the T* at raw
+        template <class T> inline
+        void assign_pointer(void* raw, void* obj_address)
+        {
+            *static_cast<T**>(raw) = static_cast<T*>(obj_address);
+        }
+
+        //! Assigns obj_address to the T* at raw, only if its value changes
+        template <class T> inline
+        void assign_changed_pointer(void* raw, void* obj_address)
+        {
+            if (*static_cast<T**>(raw) != static_cast<T*>(obj_address)) {
+                *static_cast<T**>(raw) = static_cast<T*>(obj_address);
+            }
+        }
+
+        //! A pointer retained by CRPSInputMapper for relocate
+        struct RetainedPointer
+        {
+            void* raw;                  //!< Memory address of the pointer
+            PointerAssign assign;       //!< Assigns the pointer with its type
+            std::uint32_t target;       //!< Index of the pointer's target in the retained target addresses
+        };
+    }
+
+    // ###################################################################### 
+    //! Object-ids of an external object graph, referenced by CRPS archives. 
+    /*! This class associates the memory address of each object it encounters 
+        with a graph traversal id, in the same way as CRPSOutputMapper and 
+        CRPSInputMapper. It is used to reference objects of a base graph that 
+        is saved and loaded separately, such as a large immutable dataset shared 
+        by many small archives. 
+
+        Pointers to objects of the base graph are saved as external object-ids 
+        by a CRPSOutputArchive given the ExternalObjects of the base graph, 
+        and are resolved against the loaded base graph by a CRPSInputArchive 
+        given the ExternalObjects of the loaded base graph. The base graph must 
+        be traversed identically on both sides. 
+
+        @code{cpp}
+        crps::ExternalObjects base_objects;
+        base_objects(base_dataset);
+
+        crps::CRPSInputArchive<cereal::BinaryInputArchive> crps_iarchive(iarchive);
+        crps_iarchive.setExternalObjects(base_objects);
+        crps_iarchive(overlay);
+        @endcode
+
+        Once traversed, an ExternalObjects is only read, so it may be shared by 
+        archives on several threads. */
+    class ExternalObjects : public cereal::OutputArchive<ExternalObjects, cereal::AllowEmptyClassElision>, public detail::CRPSMapperCore
+    {
+    public:
+
+        /*! @param index_addresses If false, external object-ids can be resolved by CRPSInputArchive only, 
+                                   which saves an address-to-id map for base graphs that are only loaded. */
+        ExternalObjects(bool index_addresses = true) :
+            OutputArchive<ExternalObjects, cereal::AllowEmptyClassElision>(this),
+            index_addresses(index_addresses)
+        {
+
+        }
+
+        //! Associate the object memory address with next external object-id
+        template <class T> inline
+        void trackAddress(T const& t)
+        {
+            const void* address = std::addressof(t);
+            detail::check_object_ids(obj_ptrs.size(), 1);
+            if (index_addresses) {
+                obj_ptr_to_id[address] = static_cast<std::uint32_t>(obj_ptrs.size());
+            }
+            obj_ptrs.push_back(const_cast<void*>(address));
+        }
+
+        //! Track the pointer as an object, its value is not referenced
+        template <class T> inline
+        void trackPointer(T* const& p)
+        {
+            trackAddress(p);
+        }
+
+        //! Associate each of count elements of stride bytes, starting at data, with the next external object-id
+        void trackRange(const void* data, std::size_t stride, std::size_t count)
+        {
+            detail::check_object_ids(obj_ptrs.size(), count);
+            obj_ptrs.reserve(obj_ptrs.size() + count);
+            for (std::size_t i = 0; i < count; i++) {
+                trackAddress(*(static_cast<const char*>(data) + stride * i));
+            }
+        }
+
+        /*! Finds the external object-id of the latest object tracked at address. 
+            @throws CRPSException If the ExternalObjects was created without indexing addresses. 
+            */
+        bool findObject(const void* address, std::uint32_t& id) const
+        {
+            if (!index_addresses) {
+                throw CRPSException("ExternalObjects cannot be used for saving if created without indexing addresses");
+            }
+            auto it = obj_ptr_to_id.find(address);
+            if (it == obj_ptr_to_id.end()) {
+                return false;
+            }
+            id = it->second;
+            return true;
+        }
+
+        //! Memory address of the object with the external object-id, or nullptr if id exceeds the object count
+        void* objectAddress(std::uint32_t id) const
+        {
+            return id < obj_ptrs.size() ? obj_ptrs[id] : nullptr;
+        }
+
+        //! Number of objects tracked
+        std::size_t size() const
+        {
+            return obj_ptrs.size();
+        }
+
+    private:
+        std::unordered_map<const void*, std::uint32_t> obj_ptr_to_id{}; //!< Associates object memory address with external object-id
+
+        std::vector<void*> obj_ptrs{}; //!< Associates external object-id with an object's memory address
+
+        bool index_addresses; //!< True if obj_ptr_to_id is generated
+    };
+
+    namespace detail
+    {
+        //! A memory address and an id, spilled to a temporary file or kept in a sorted log by CRPSOutputMapper
+        struct SpillEntry
+        {
+            std::uintptr_t address;     //!< Memory address of an object, or value of a pointer
+            std::uint32_t id;           //!< Object-id of the object, or pointer-id of the pointer
+
+            bool operator<(SpillEntry const& other) const
+            {
+                return address < other.address || (address == other.address && id < other.id);
+            }
+
+            bool operator>(SpillEntry const& other) const
+            {
+                return other < *this;
+            }
+        };
+
+        //! Closes a temporary file
+        struct FileCloser
+        {
+            void operator()(std::FILE* file) const
+            {
+                std::fclose(file);
+            }
+        };
+
+        // ######################################################################
+        //! Entries buffered up to a capacity, then written to temporary files as sorted runs.
+        /*! The runs are read back in ascending order by SpillMerge. Temporary files are
+            created with std::tmpfile, and are removed when closed.
+            @internal */
+        class SpillRuns
+        {
+        public:
+
+            //! Number of entries buffered in memory before they are written as a run, 0 if disabled
+            void setCapacity(std::size_t entries)
+            {
+                capacity = entries;
+            }
+
+            //! True if entries are buffered and spilled, rather than stored by the caller
+            bool enabled() const
+            {
+                return capacity != 0;
+            }
+
+            //! Adds an entry, writing the buffer as a run if it is full
+            void push(std::uintptr_t address, std::uint32_t id)
+            {
+                buffer.push_back(SpillEntry{ address, id });
+                if (buffer.size() >= capacity) {
+                    spill();
+                }
+            }
+
+            /*! Writes the buffered entries as a sorted run.
+                @throws CRPSException If the temporary file cannot be created or written. */
+            void spill()
+            {
+                if (buffer.empty()) {
+                    return;
+                }
+                std::sort(buffer.begin(), buffer.end());
+
+                std::unique_ptr<std::FILE, FileCloser> file(std::tmpfile());
+                if (!file) {
+                    throw CRPSException("Failed to create temporary file for spilled book-keeping");
+                }
+                if (std::fwrite(buffer.data(), sizeof(SpillEntry), buffer.size(), file.get()) != buffer.size()) {
+                    throw CRPSException("Failed to write spilled book-keeping to temporary file");
+                }
+
+                runs.emplace_back(std::move(file), buffer.size());
+                levels.push_back(0);
+                buffer.clear();
+
+                // levels never increase towards the newest run, so runs of the newest level are at the end
+                while (runs.size() >= merge_fan_in && levels[runs.size() - merge_fan_in] == levels.back()) {
+                    mergeRuns(runs.size() - merge_fan_in);
+                }
+            }
+
+            //! Discards all entries and runs
+            void clear()
+            {
+                buffer.clear();
+                runs.clear();
+                levels.clear();
+            }
+
+            //! Number of entries buffered in memory before they are written as a run
+            std::size_t bufferCapacity() const
+            {
+                return capacity;
+            }
+
+            //! Temporary files of the runs, with their entry counts
+            std::vector<std::pair<std::unique_ptr<std::FILE, FileCloser>, std::size_t>> const& spilledRuns() const
+            {
+                return runs;
+            }
+
+        private:
+
+            /*! Merges the runs from first to the last into one run of the next level. Runs are merged 
+                in levels: once merge_fan_in runs of a level are written, they become one run of the 
+                next level. Each entry is therefore rewritten once per level, a logarithmic number of 
+                times, and fewer than merge_fan_in runs of each level remain open. 
+                @throws CRPSException If a temporary file cannot be created, read or written. */
+            void mergeRuns(std::size_t first);
+
+        private:
+            static const std::size_t merge_fan_in = 16; //!< Number of runs of one level that are merged into a run of the next level
+
+            std::vector<SpillEntry> buffer{}; //!< Entries not yet written as a run
+
+            std::vector<std::pair<std::unique_ptr<std::FILE, FileCloser>, std::size_t>> runs{}; //!< Temporary files of the runs, with their entry counts
+
+            std::vector<std::size_t> levels{}; //!< Merge level of each run, 0 for a run written from the buffer
+
+            std::size_t capacity{}; //!< Number of entries buffered before a run is written, 0 if disabled
+        };
+
+        // ######################################################################
+        //! Reads the runs of a SpillRuns in ascending order with a k-way merge.
+        /*! Each run is read in blocks, which together use about the buffer capacity of the SpillRuns.
+            @internal */
+        class SpillMerge
+        {
+        public:
+
+            /*! @param spill_runs The runs to merge, whose buffer must be spilled
+                @throws CRPSException If a temporary file cannot be read. */
+            SpillMerge(SpillRuns const& spill_runs) :
+                SpillMerge(spill_runs.spilledRuns(), spill_runs.bufferCapacity())
+            {
+
+            }
+
+            /*! @param runs Temporary files of the runs to merge, with their entry counts
+                @param capacity Number of entries to read in blocks, across all runs
+                @throws CRPSException If a temporary file cannot be read. */
+            SpillMerge(std::vector<std::pair<std::unique_ptr<std::FILE, FileCloser>, std::size_t>> const& runs, std::size_t capacity) :
+                runs(runs)
+            {
+                const std::size_t block = std::max<std::size_t>(capacity / std::max<std::size_t>(runs.size(), 1), 64);
+
+                readers.resize(runs.size());
+                for (std::size_t i = 0; i < runs.size(); i++)
+                {
+                    std::rewind(runs[i].first.get());
+                    readers[i].remaining = runs[i].second;
+                    readers[i].block.resize(std::min(block, runs[i].second));
+                    readers[i].position = readers[i].block.size();
+                    advance(i);
+                }
+            }
+
+            //! Retrieves the next entry in ascending order, returns false once all entries are read
+            bool next(SpillEntry& entry)
+            {
+                if (heads.empty()) {
+                    return false;
+                }
+                std::pop_heap(heads.begin(), heads.end(), std::greater<std::pair<SpillEntry, std::size_t>>());
+                entry = heads.back().first;
+                const std::size_t run = heads.back().second;
+                heads.pop_back();
+
+                advance(run);
+                return true;
+            }
+
+        private:
+
+            //! Reads a run in blocks
+            struct Reader
+            {
+                std::vector<SpillEntry> block;  //!< Entries read from the run
+                std::size_t position;           //!< Index of the next entry of block
+                std::size_t remaining;          //!< Number of entries of the run not yet read into block
+            };
+
+            //! Pushes the next entry of a run onto the heap, reading the next block if required
+            void advance(std::size_t run)
+            {
+                Reader& reader = readers[run];
+
+                if (reader.position == reader.block.size())
+                {
+                    if (reader.remaining == 0) {
+                        return;
+                    }
+                    const std::size_t count = std::min(reader.block.size(), reader.remaining);
+                    if (std::fread(reader.block.data(), sizeof(SpillEntry), count, runs[run].first.get()) != count) {
+                        throw CRPSException("Failed to read spilled book-keeping from temporary file");
+                    }
+                    reader.block.resize(count);
+                    reader.remaining -= count;
+                    reader.position = 0;
+                }
+
+                heads.emplace_back(reader.block[reader.position++], run);
+                std::push_heap(heads.begin(), heads.end(), std::greater<std::pair<SpillEntry, std::size_t>>());
+            }
+
+        private:
+            std::vector<std::pair<std::unique_ptr<std::FILE, FileCloser>, std::size_t>> const& runs; //!< Temporary files of the runs, with their entry counts
+
+            std::vector<Reader> readers{}; //!< Block reader of each run
+
+            std::vector<std::pair<SpillEntry, std::size_t>> heads{}; //!< Min-heap of the next entry of each run, with its run index
+        };
+
+        inline void SpillRuns::mergeRuns(std::size_t first)
+        {
+            std::unique_ptr<std::FILE, FileCloser> file(std::tmpfile());
+            if (!file) {
+                throw CRPSException("Failed to create temporary file for spilled book-keeping");
+            }
+
+            const std::size_t level = levels[first] + 1;
+            std::vector<std::pair<std::unique_ptr<std::FILE, FileCloser>, std::size_t>> newer{};
+            std::move(runs.begin() + static_cast<std::ptrdiff_t>(first), runs.end(), std::back_inserter(newer));
+            runs.resize(first);
+            levels.resize(first);
+
+            std::size_t count = 0;
+            {
+                SpillMerge merge(newer, capacity);
+                std::vector<SpillEntry> block{};
+                block.reserve(std::max<std::size_t>(capacity, 64));
+
+                auto write = [&]() {
+                    if (std::fwrite(block.data(), sizeof(SpillEntry), block.size(), file.get()) != block.size()) {
+                        throw CRPSException("Failed to write spilled book-keeping to temporary file");
+                    }
+                    count += block.size();
+                    block.clear();
+                };
+
+                SpillEntry entry;
+                while (merge.next(entry))
+                {
+                    block.push_back(entry);
+                    if (block.size() == block.capacity()) {
+                        write();
+                    }
+                }
+                write();
+            }
+
+            runs.emplace_back(std::move(file), count);
+            levels.push_back(level);
+        }
+
+        //! An object owned by a placed_ptr, to be moved into a PlacementArena by CRPSInputMapper
+        struct Placement
+        {
+            void* owner;                                //!< Memory address of the placed_ptr
+            void* object;                               //!< Memory address of the object before it is placed
+            std::size_t size;                           //!< Size of the object in bytes
+            void* (*place)(void* owner, PlacementArena& arena); //!< Moves the object of owner into arena, makes owner own it and returns it
+        };
+
+        //! Moves the object of a placed_ptr into a PlacementArena, destroying the original
+        template <class T>
+        void* place_object(void* owner, PlacementArena& arena)
+        {
+            placed_ptr<T>& ptr = *static_cast<placed_ptr<T>*>(owner);
+            T* placed = ::new (arena.allocate(sizeof(T), alignof(T))) T(std::move(*ptr));
+            ptr = placed_ptr<T>(placed, PlacementDeleter<T>(&arena));
+            return placed;
+        }
+
+        //! An array tracked by CRPSInputMapper with one object-id per element
+        struct AddressRange
+        {
+            std::uint32_t first_id;     //!< Object-id of the first element
+            std::uint32_t count;        //!< Number of elements
+            std::uint32_t range_ids;    //!< Number of object-ids of this range and of the ranges before it
+            std::size_t stride;         //!< Size of an element in bytes
+            void* base;                 //!< Memory address of the first element
+        };
+
+        //! Objects tracked at equally spaced memory addresses with consecutive object-ids
+        struct AddressRun
+        {
+            std::uintptr_t base;        //!< Memory address of the first object
+            std::uintptr_t stride;      //!< Distance in bytes between the objects, 0 for a single object
+            std::uint32_t count;        //!< Number of objects, 0 for no run
+            std::uint32_t first_id;     //!< Object-id of the first object
+
+            //! Memory address of the last object
+            std::uintptr_t last() const
+            {
+                return base + stride * (count - 1);
+            }
+
+            //! Finds the object-id of the object of the run at address
+            bool find(std::uintptr_t address, std::uint32_t& id) const
+            {
+                if (count == 0 || address < base || address > last()) {
+                    return false;
+                }
+                if (stride == 0) {
+                    id = first_id;
+                    return true;
+                }
+                if ((address - base) % stride != 0) {
+                    return false;
+                }
+                id = first_id + static_cast<std::uint32_t>((address - base) / stride);
+                return true;
+            }
+        };
+
+        //! A span of memory addresses of the objects of a fragment spliced into a CRPSOutputMapper
+        struct SplicedRange
+        {
+            std::uintptr_t lowest;      //!< Memory address of the lowest object of the span
+            std::uintptr_t highest;     //!< Memory address of the highest object of the span
+            std::uintptr_t reach;       //!< Memory address of the highest object of this range and of the ranges sorted before it
+            std::size_t fragment;       //!< Index of the fragment in the order of splicing
+
+            //! Orders ranges by their lowest object
+            bool operator<(SplicedRange const& other) const
+            {
+                return lowest < other.lowest;
+            }
+        };
+
+        // ######################################################################
+        //! Counts the book-keeping of a mapper against its CRPSLimits.
+        /*! @internal */
+        class BookkeepingBudget
+        {
+        public:
+
+            void setLimits(CRPSLimits const& new_limits)
+            {
+                limits = new_limits;
+            }
+
+            /*! Counts tracked objects and the bytes of their book-keeping.
+                @throws CRPSException If the object or byte limit is exceeded. */
+            void addObjects(std::size_t count, std::size_t bytes)
+            {
+                objects += count;
+                if (objects > limits.max_objects) {
+                    throw CRPSException("Pointer book-keeping exceeds the limit of " + std::to_string(limits.max_objects) + " objects");
+                }
+                addBytes(bytes);
+            }
+
+            /*! Counts a tracked pointer and the bytes of its book-keeping.
+                @throws CRPSException If the pointer or byte limit is exceeded. */
+            void addPointer(std::size_t bytes)
+            {
+                if (++pointers > limits.max_pointers) {
+                    throw CRPSException("Pointer book-keeping exceeds the limit of " + std::to_string(limits.max_pointers) + " pointers");
+                }
+                pointer_bytes += bytes;
+                checkBytes();
+            }
+
+            /*! Counts bytes of object book-keeping.
+                @throws CRPSException If the byte limit is exceeded. */
+            void addBytes(std::size_t bytes)
+            {
+                object_bytes += bytes;
+                checkBytes();
+            }
+
+            //! Stops counting the pointers, once their book-keeping is released
+            void releasePointers()
+            {
+                pointers = 0;
+                pointer_bytes = 0;
+            }
+
+            //! Stops counting count objects and bytes of their book-keeping, once released
+            void releaseObjects(std::size_t count, std::size_t bytes)
+            {
+                objects -= std::min(objects, count);
+                object_bytes -= std::min(object_bytes, bytes);
+            }
+
+            //! Stops counting the objects and pointers, once their book-keeping is released
+            void clear()
+            {
+                objects = 0;
+                object_bytes = 0;
+                releasePointers();
+            }
+
+        private:
+
+            void checkBytes() const
+            {
+                if (object_bytes + pointer_bytes > limits.max_bytes) {
+                    throw CRPSException("Pointer book-keeping exceeds the limit of " + std::to_string(limits.max_bytes) + " bytes");
+                }
+            }
+
+        private:
+            CRPSLimits limits{}; //!< Limits checked by each count
+
+            std::size_t objects{};          //!< Tracked objects
+            std::size_t pointers{};         //!< Tracked pointers
+            std::size_t object_bytes{};     //!< Estimated bytes of the object table
+            std::size_t pointer_bytes{};    //!< Estimated bytes of the pointer table
+        };
+
+        //! A pointer_id_to_object_id map to be loaded, whose saved size must match the tracked pointer count, see check_table_size
+        struct BoundedTable
+        {
+            std::vector<std::uint32_t>& raw_to_obj;     //!< Loaded map
+            std::size_t count;                          //!< Number of pointers tracked by the traversal
+        };
+
+        /*! Rejects a pointer_id_to_object_id map size that does not match the traversal, before it is allocated. 
+            The map has an entry per pointer, followed by an offset per pointer to a member of a blit array element. 
+            @throws CRPSException If size is less than count, or more than twice count. */
+        inline void check_table_size(cereal::size_type size, std::size_t count)
+        {
+            if (size < static_cast<cereal::size_type>(count) || size - static_cast<cereal::size_type>(count) > static_cast<cereal::size_type>(count)) {
+                throw CRPSException("Size of raw_ptr_to_obj_id map loaded from input archive does not match size of map generated from traversal");
+            }
+        }
+
+        //! Loads a pointer_id_to_object_id map saved as a std::vector of binary data, checking its size first
+        template <class Archive> inline
+        typename std::enable_if<cereal::traits::is_input_serializable<cereal::BinaryData<std::uint32_t>, Archive>::value, void>::type
+        CEREAL_LOAD_FUNCTION_NAME(Archive& ar, BoundedTable& table)
+        {
+            cereal::size_type size;
+            ar(cereal::make_size_tag(size));
+            check_table_size(size, table.count);
+
+            table.raw_to_obj.resize(static_cast<std::size_t>(size));
+            ar(cereal::binary_data(table.raw_to_obj.data(), table.raw_to_obj.size() * sizeof(std::uint32_t)));
+        }
+
+        //! Loads a pointer_id_to_object_id map saved as a std::vector of elements, checking its size first
+        template <class Archive> inline
+        typename std::enable_if<!cereal::traits::is_input_serializable<cereal::BinaryData<std::uint32_t>, Archive>::value, void>::type
+        CEREAL_LOAD_FUNCTION_NAME(Archive& ar, BoundedTable& table)
+        {
+            cereal::size_type size;
+            ar(cereal::make_size_tag(size));
+            check_table_size(size, table.count);
+
+            table.raw_to_obj.resize(static_cast<std::size_t>(size));
+            for (auto& id : table.raw_to_obj) {
+                ar(id);
+            }
+        }
+
+        //! True if Archive saves binary values, as the text archives of cereal do
+        template <class Archive, class = void>
+        struct has_save_binary_value : std::false_type {};
+
+        template <class Archive>
+        struct has_save_binary_value<Archive, decltype(std::declval<Archive&>().saveBinaryValue(static_cast<const void*>(nullptr), std::size_t{}, static_cast<const char*>(nullptr)))> : std::true_type {};
+
+        //! True if Archive loads binary values, as the text archives of cereal do
+        template <class Archive, class = void>
+        struct has_load_binary_value : std::false_type {};
+
+        template <class Archive>
+        struct has_load_binary_value<Archive, decltype(std::declval<Archive&>().loadBinaryValue(static_cast<void*>(nullptr), std::size_t{}, static_cast<const char*>(nullptr)))> : std::true_type {};
+
+        /*! Saves pointer_id_to_object_id map as its count and one binary value, which text archives encode as base64. 
+            The binary value stores each object-id as 4 little-endian bytes, independent of the platform. */
+        template <class Archive> inline
+        typename std::enable_if<has_save_binary_value<Archive>::value, void>::type
+        save_packed_table(Archive& ar, std::vector<std::uint32_t> const& raw_to_obj)
+        {
+            const cereal::size_type count = static_cast<cereal::size_type>(raw_to_obj.size());
+            ar(cereal::make_nvp("crps_pointer_count", count));
+
+            std::vector<unsigned char> bytes(raw_to_obj.size() * 4);
+            for (std::size_t i = 0; i < raw_to_obj.size(); i++)
+            {
+                for (std::size_t b = 0; b < 4; b++) {
+                    bytes[i * 4 + b] = static_cast<unsigned char>(raw_to_obj[i] >> (b * 8));
+                }
+            }
+            ar.saveBinaryValue(bytes.data(), bytes.size(), "crps_pointers");
+        }
+
+        //! Saves pointer_id_to_object_id map as a vector, for archives without binary values
+        template <class Archive> inline
+        typename std::enable_if<!has_save_binary_value<Archive>::value, void>::type
+        save_packed_table(Archive& ar, std::vector<std::uint32_t> const& raw_to_obj)
+        {
+            ar(raw_to_obj);
+        }
+
+        /*! Loads pointer_id_to_object_id map saved by save_packed_table.
+            @param pointer_count Number of pointers tracked by the traversal, which the saved count must match, see check_table_size */
+        template <class Archive> inline
+        typename std::enable_if<has_load_binary_value<Archive>::value, std::vector<std::uint32_t>>::type
+        load_packed_table(Archive& ar, std::size_t pointer_count)
+        {
+            cereal::size_type count;
+            ar(cereal::make_nvp("crps_pointer_count", count));
+            check_table_size(count, pointer_count);
+
+            std::vector<unsigned char> bytes(static_cast<std::size_t>(count) * 4);
+            ar.loadBinaryValue(bytes.data(), bytes.size(), "crps_pointers");
+
+            std::vector<std::uint32_t> raw_to_obj(static_cast<std::size_t>(count));
+            for (std::size_t i = 0; i < raw_to_obj.size(); i++)
+            {
+                for (std::size_t b = 0; b < 4; b++) {
+                    raw_to_obj[i] |= static_cast<std::uint32_t>(bytes[i * 4 + b]) << (b * 8);
+                }
+            }
+            return raw_to_obj;
+        }
+
+        /*! Loads pointer_id_to_object_id map saved by save_packed_table, for archives without binary values.
+            @param pointer_count Number of pointers tracked by the traversal, which the saved count must match, see check_table_size */
+        template <class Archive> inline
+        typename std::enable_if<!has_load_binary_value<Archive>::value, std::vector<std::uint32_t>>::type
+        load_packed_table(Archive& ar, std::size_t pointer_count)
+        {
+            std::vector<std::uint32_t> raw_to_obj{};
+            BoundedTable table{ raw_to_obj, pointer_count };
+            ar(table);
+            return raw_to_obj;
+        }
+    }
+
+    // ###################################################################### 
+    //! Performs pointer book-keeping when saving classes to an OutputArchive. 
+    /*! This class is used by CRPSOutputArchive to associate the memory address
+        of each object or pointer it encounters with a graph traversal id. 
+        CRPSInputArchive then provides this class with the user's archive to 
+        save book-keeping (in the form of a pointer-id to object-id map) created 
+        by the graph traversal data. 
+
+        @internal */
+    class CRPSOutputMapper : public cereal::OutputArchive<CRPSOutputMapper, cereal::AllowEmptyClassElision>, public detail::CRPSMapperCore
+    {
+    public:
+
+        //! Empty object_address_to_object_id map associates an address of nullptr to an object-id of 0
+        CRPSOutputMapper() :
+            OutputArchive<CRPSOutputMapper, cereal::AllowEmptyClassElision>(this)
+        {
+            obj_ptr_to_id[nullptr] = map_insert_count++;
+        }
+
+        /*! Selects the index of the objects that are not coalesced into address runs. 
+            By default the backend is chosen automatically, once the traversal has tracked 
+            backend_sample_size objects: the Hash backend if at least dense_pointer_percent 
+            pointers were tracked per hundred objects stored in the index, otherwise the SortedLog 
+            backend, whose sort and binary searches cost less than hashing while lookups are few. 
+            The choice of the Hash backend is sampled again each time the object count doubles, 
+            and turns to the SortedLog backend once the index reaches index_cache_bytes, as the 
+            sorted log is faster at any density once the hash map no longer fits in the cache. 
+            Objects tracked before the call are moved to the selected backend. 
+            */
+        void setBackend(CRPSBackend selected)
+        {
+            automatic_backend = selected == CRPSBackend::Automatic;
+            next_backend_sample = backend_sample_size;
+            useBackend(automatic_backend ? CRPSBackend::Hash : selected);
+        }
+
+        //! Counts an object of cereal::defer, called before the deferment is queued
+        void trackDeferment()
+        {
+            deferment_count++;
+        }
+
+        //! Number of objects of cereal::defer serialized so far
+        std::size_t deferments() const
+        {
+            return deferment_count;
+        }
+
+        /*! Computes the address spans of the tracked objects, by which the mapper is found once 
+            spliced as a fragment, and sorts its lookups. Objects less than max_span_gap bytes 
+            apart share a span, so a span usually covers an object with its members, or an array. 
+            Called by spliceFragment, and by FragmentCache before a fragment is shared. 
+            */
+        void prepareSplicing() const
+        {
+            prepareLookups();
+            if (object_spans_prepared) {
+                return;
+            }
+
+            std::vector<std::pair<std::uintptr_t, std::uintptr_t>> bounds{};
+            for (detail::SpillEntry const& entry : object_log) {
+                bounds.emplace_back(entry.address, entry.address);
+            }
+            for (auto const& entry : obj_ptr_to_id) {
+                bounds.emplace_back(reinterpret_cast<std::uintptr_t>(entry.first), reinterpret_cast<std::uintptr_t>(entry.first));
+            }
+            for (auto const& run : address_runs) {
+                bounds.emplace_back(run.second.base, run.second.last());
+            }
+            if (current_run.count != 0) {
+                bounds.emplace_back(current_run.base, current_run.last());
+            }
+            for (auto const& range : blit_ranges) {
+                bounds.emplace_back(range.second.base, range.second.base + range.second.stride * range.second.count - 1);
+            }
+            for (detail::SplicedRange const& range : spliced_ranges) {
+                bounds.emplace_back(range.lowest, range.highest);
+            }
+            std::sort(bounds.begin(), bounds.end());
+
+            for (auto const& bound : bounds)
+            {
+                if (bound.first == 0) {
+                    continue;
+                }
+                if (!object_spans.empty() && (bound.first <= object_spans.back().second || bound.first - object_spans.back().second <= max_span_gap)) {
+                    object_spans.back().second = std::max(object_spans.back().second, bound.second);
+                }
+                else {
+                    object_spans.push_back(bound);
+                }
+            }
+            object_spans_prepared = true;
+        }
+
+        //! Statistics of the book-keeping tracked so far, including the selected backend
+        CRPSMapperStats stats() const
+        {
+            CRPSMapperStats result{};
+            result.backend = backend;
+            result.automatic = automatic_backend || backend_sampled;
+            result.spilled = spilled_objects.enabled();
+            result.objects = map_insert_count - 1;
+            result.pointers = spilled_pointers.enabled() ? spilled_pointer_count : raw_ptr_values.size();
+            result.table_entries = (backend == CRPSBackend::SortedLog ? object_log.size() : obj_ptr_to_id.size()) - 1;
+            result.address_runs = address_runs.size() + (current_run.count >= min_stored_run ? 1 : 0);
+            return result;
+        }
+
+        /*! Sorts the objects of the SortedLog backend and the address ranges of spliced fragments, 
+            as required before objects are looked up. 
+            Called by resolvePointers, and by prepareSplicing. 
+            */
+        void prepareLookups() const
+        {
+            if (!spliced_ranges_sorted)
+            {
+                std::sort(spliced_ranges.begin(), spliced_ranges.end());
+                std::uintptr_t reach = 0;
+                for (detail::SplicedRange& range : spliced_ranges) {
+                    reach = std::max(reach, range.highest);
+                    range.reach = reach;
+                }
+                spliced_ranges_sorted = true;
+            }
+            if (sorted_log_size == object_log.size()) {
+                return;
+            }
+            const auto unsorted = object_log.begin() + static_cast<std::ptrdiff_t>(sorted_log_size);
+            std::sort(unsorted, object_log.end());
+            std::inplace_merge(object_log.begin(), unsorted, object_log.end());
+            sorted_log_size = object_log.size();
+        }
+
+        /*! Creates pointer_id_to_object_id map from pointers/objects tracked from traversal. 
+            Saves map to output_archive. 
+   
+            @param output_archive A copy of the users's output_archive reference stored in the CRPSInputArchive 
+            */
+        template <class Archive>
+        void complete(Archive& output_archive)
+        {
+            std::vector<std::uint32_t> raw_to_obj = pointerTable();
+
+            output_archive(raw_to_obj);
+        }
+
+        /*! Creates pointer_id_to_object_id map from pointers/objects tracked from traversal. 
+
+            @throws CRPSException If a pointer value is not the address of an object visited by the traversal. 
+            */
+        std::vector<std::uint32_t> pointerTable() const
+        {
+            std::vector<std::uint32_t> raw_to_obj{};
+            resolvePointers(raw_to_obj, std::chrono::steady_clock::time_point::max());
+
+            return raw_to_obj;
+        }
+
+        /*! Continues creating pointer_id_to_object_id map until it is complete, or until deadline. 
+            The deadline is checked after each chunk of pointers. 
+
+            @param raw_to_obj The partial map, which is extended in place
+            @returns True if the map is complete
+            @throws CRPSException If a pointer value is not the address of an object visited by the traversal. 
+            */
+        bool resolvePointers(std::vector<std::uint32_t>& raw_to_obj, std::chrono::steady_clock::time_point deadline) const
+        {
+            CRPS_TRACE_SCOPE("pointer_table");
+            CRPS_TRACE_STATS(stats());
+            prepareLookups();
+
+            if (spilled_pointers.enabled()) {
+                raw_to_obj = resolveSpilledPointers();
+                return true;
+            }
+
+            static const std::size_t chunk_size = 4096;
+            raw_to_obj.reserve(raw_ptr_values.size());
+
+            while (raw_to_obj.size() < raw_ptr_values.size())
+            {
+                std::size_t chunk_end = std::min(raw_ptr_values.size(), raw_to_obj.size() + chunk_size);
+
+                for (std::size_t i = raw_to_obj.size(); i < chunk_end; i++) 
+                {
+                    const void* rpv = raw_ptr_values[i];
+                    std::uint32_t id;
+                    std::uint32_t offset;
+                    if (!findObject(rpv, id) && !findExternalObject(rpv, id) && !findMemberObject(rpv, id, offset)) 
+                    {
+                        std::ostringstream address{};
+                        address << rpv;
+                        throw CRPSException("Memory address " + address.str() + " not found in serialization traversal");
+                    }
+                    raw_to_obj.push_back(id);
+                }
+
+                if (raw_to_obj.size() < raw_ptr_values.size() && std::chrono::steady_clock::now() >= deadline) {
+                    return false;
+                }
+            }
+
+            // the offsets of pointers to members follow the map, once, in pointer order
+            if (raw_to_obj.size() == raw_ptr_values.size())
+            {
+                for (std::size_t i = 0; i < raw_ptr_values.size(); i++)
+                {
+                    std::uint32_t id;
+                    std::uint32_t offset;
+                    if (detail::is_member_object(raw_to_obj[i]) && findMemberObject(raw_ptr_values[i], id, offset)) {
+                        raw_to_obj.push_back(offset);
+                    }
+                }
+            }
+            return true;
+        }
+
+        //! Throws a CRPSException from the traversal once its book-keeping exceeds limits
+        void setLimits(CRPSLimits const& limits)
+        {
+            budget.setLimits(limits);
+        }
+
+        /*! Keeps the book-keeping of the traversal within about budget bytes of memory, by writing 
+            sorted runs of object addresses and pointer values to temporary files. The pointer-id to 
+            object-id map is then created by merging the runs, and is not created in slices. 
+            Runs of 16 or more equally spaced objects remain in memory, as they are stored compactly. 
+            A budget of 0 keeps the book-keeping in memory, which is the default. 
+
+            @param budget Bytes of memory for buffered book-keeping, split between objects and pointers 
+            */
+        void setSpillBudget(std::size_t budget)
+        {
+            const std::size_t capacity = budget / (2 * sizeof(detail::SpillEntry));
+            spilled_objects.setCapacity(budget == 0 ? 0 : std::max<std::size_t>(capacity, 1));
+            spilled_pointers.setCapacity(budget == 0 ? 0 : std::max<std::size_t>(capacity, 1));
+
+            if (spilled_pointers.enabled()) 
+            {
+                for (const void* value : raw_ptr_values) {
+                    spilled_pointers.push(reinterpret_cast<std::uintptr_t>(value), spilled_pointer_count++);
+                }
+                std::vector<const void*>().swap(raw_ptr_values);
+            }
+        }
+
+        /*! Associate the object memory address with next object id. 
+            Objects tracked at equally spaced addresses, such as the elements of an array, 
+            are coalesced into a run instead of being stored one by one. 
+            */
+        template <class T> inline
+        void trackAddress(T const& t)
+        {
+            trackObject(reinterpret_cast<std::uintptr_t>(std::addressof(t)));
+        }
+
+        //! Associate the pointer value with next pointer id, and track it as an object
+        template <class T> inline
+        void trackPointer(T* const& p)
+        {
+            trackPointerValue(p);
+            trackAddress(p);
+        }
+
+        /*! Associate each of count elements of stride bytes, starting at data, with the next object id, as one run. 
+            The range is also kept whole, so pointers to members of its elements are found by findMemberObject. 
+            @throws CRPSException If the elements exceed the available object-ids. 
+            */
+        void trackRange(const void* data, std::size_t stride, std::size_t count)
+        {
+            if (count == 0) {
+                return;
+            }
+            detail::check_object_ids(map_insert_count, count);
+            budget.addObjects(1, run_entry_bytes);
+
+            storeRun();
+            current_run = detail::AddressRun{ reinterpret_cast<std::uintptr_t>(data), stride, static_cast<std::uint32_t>(count), map_insert_count };
+            blit_ranges[current_run.base] = current_run;
+            map_insert_count += static_cast<std::uint32_t>(count);
+        }
+
+        /*! Continues the traversal with the objects and pointers tracked by another mapper, 
+            as if its traversal was repeated by this mapper. The object-ids of the fragment 
+            are shifted by the current object count, and are looked up in the fragment itself, 
+            which is found by the address spans of its objects in a sorted index. The cost of 
+            splicing grows with the number of spans, not with the number of objects. 
+
+            @param fragment A mapper that traversed an object which has not changed since. 
+            */
+        void spliceFragment(std::shared_ptr<const CRPSOutputMapper> const& fragment)
+        {
+            detail::check_object_ids(map_insert_count, fragment->map_insert_count - 1);
+            fragment->prepareSplicing();
+            budget.addObjects(fragment->map_insert_count - 1, sizeof(spliced_fragments.front()) + fragment->object_spans.size() * sizeof(detail::SplicedRange));
+            for (auto const& span : fragment->object_spans) {
+                spliced_ranges.push_back(detail::SplicedRange{ span.first, span.second, 0, spliced_fragments.size() });
+            }
+            spliced_ranges_sorted = false;
+            spliced_fragments.emplace_back(map_insert_count - 1, fragment);
+            map_insert_count += fragment->map_insert_count - 1;
+            for (const void* value : fragment->raw_ptr_values) {
+                trackPointerValue(value);
+            }
+        }
+
+        //! Forwards to cereal::OutputArchive::registerSharedPointer, and counts the registration
+        template <class Pointer> inline
+        std::uint32_t registerSharedPointer(Pointer const& ptr)
+        {
+            ++archive_registrations;
+            return OutputArchive<CRPSOutputMapper, cereal::AllowEmptyClassElision>::registerSharedPointer(ptr);
+        }
+
+        //! Forwards to cereal::OutputArchive::registerPolymorphicType, and counts the registration
+        template <class Name> inline
+        std::uint32_t registerPolymorphicType(Name const& name)
+        {
+            ++archive_registrations;
+            return OutputArchive<CRPSOutputMapper, cereal::AllowEmptyClassElision>::registerPolymorphicType(name);
+        }
+
+        //! Number of shared pointers and polymorphic types registered by the traversal
+        std::size_t archiveRegistrations() const
+        {
+            return archive_registrations;
+        }
+
+        //! Save pointers to objects not found in the traversal as external object-ids of objects, if tracked by objects
+        void setExternalObjects(ExternalObjects const& objects)
+        {
+            external_objects = &objects;
+        }
+
+        //! Next available object-id, which is the number of objects tracked so far plus one for nullptr
+        std::uint32_t objectCount() const
+        {
+            return map_insert_count;
+        }
+
+        /*! Discards the pointers tracked so far, once their pointer_id_to_object_id map is saved. 
+            Objects remain tracked, so pointers tracked later may still reference them. 
+            */
+        void releasePointers()
+        {
+            raw_ptr_values.clear();
+            spilled_pointers.clear();
+            spilled_pointer_count = 0;
+            budget.releasePointers();
+        }
+
+        /*! Stops finding the objects with an object-id below first_id, so pointers tracked later 
+            cannot reference them. Their entries are erased from the index and the address runs 
+            once at least half of the tracked objects are forgotten, so erasing costs a constant 
+            per object. Objects of spliced fragments are not erased, only no longer found. 
+            */
+        void forgetObjects(std::uint32_t first_id)
+        {
+            forgotten_ids = std::max(forgotten_ids, first_id);
+            if (2 * (forgotten_ids - erased_ids) < map_insert_count - erased_ids) {
+                return;
+            }
+
+            auto forgotten = [&](std::uint32_t id) { return id != 0 && id < forgotten_ids; };
+            std::size_t erased_bytes = 0;
+
+            for (auto entry = obj_ptr_to_id.begin(); entry != obj_ptr_to_id.end(); )
+            {
+                if (forgotten(entry->second)) {
+                    entry = obj_ptr_to_id.erase(entry);
+                    erased_bytes += object_entry_bytes;
+                }
+                else {
+                    ++entry;
+                }
+            }
+
+            const auto sorted_end = object_log.begin() + static_cast<std::ptrdiff_t>(sorted_log_size);
+            sorted_log_size -= static_cast<std::size_t>(std::count_if(object_log.begin(), sorted_end, 
+                [&](detail::SpillEntry const& entry) { return forgotten(entry.id); }));
+            const auto log_end = std::remove_if(object_log.begin(), object_log.end(), 
+                [&](detail::SpillEntry const& entry) { return forgotten(entry.id); });
+            erased_bytes += static_cast<std::size_t>(object_log.end() - log_end) * sizeof(detail::SpillEntry);
+            object_log.erase(log_end, object_log.end());
+
+            for (auto* runs : { &address_runs, &blit_ranges })
+            {
+                for (auto run = runs->begin(); run != runs->end(); )
+                {
+                    if (run->second.first_id + run->second.count <= forgotten_ids) {
+                        run = runs->erase(run);
+                        erased_bytes += run_entry_bytes;
+                    }
+                    else {
+                        ++run;
+                    }
+                }
+            }
+
+            budget.releaseObjects(forgotten_ids - erased_ids, erased_bytes);
+            erased_ids = forgotten_ids;
+        }
+
+    private:
+
+        //! Finds the flagged external object-id of the object at address
+        bool findExternalObject(const void* address, std::uint32_t& id) const
+        {
+            if (external_objects == nullptr || !external_objects->findObject(address, id)) {
+                return false;
+            }
+            id |= detail::external_object_flag;
+            return true;
+        }
+
+        //! Extends the current run with the object at address and the next object-id, or starts a new run
+        void trackObject(std::uintptr_t address)
+        {
+            detail::check_object_ids(map_insert_count, 1);
+            budget.addObjects(1, 0);
+            if (automatic_backend && map_insert_count >= next_backend_sample) {
+                sampleBackend();
+            }
+            const std::uint32_t id = map_insert_count++;
+
+            if (current_run.count != 0 && id == current_run.first_id + current_run.count)
+            {
+                if (current_run.count == 1 && address > current_run.base && address - current_run.base <= max_run_stride) {
+                    current_run.stride = address - current_run.base;
+                    current_run.count = 2;
+                    return;
+                }
+                if (current_run.count > 1 && address == current_run.base + current_run.stride * current_run.count) {
+                    ++current_run.count;
+                    return;
+                }
+            }
+
+            storeRun();
+            current_run = detail::AddressRun{ address, 0, 1, id };
+        }
+
+        /*! Stores the current run. A run shorter than min_stored_run, or overlapping a stored run, 
+            is stored one object at a time, so that short runs do not cost a map node and a map 
+            search per lookup, and at most one stored run contains an address. 
+            */
+        void storeRun()
+        {
+            if (current_run.count == 0) {
+                return;
+            }
+
+            if (current_run.count < min_stored_run || overlapsStoredRun(current_run))
+            {
+                for (std::uint32_t i = 0; i < current_run.count; i++) {
+                    trackObjectId(current_run.base + current_run.stride * i, current_run.first_id + i);
+                }
+            }
+            else {
+                budget.addBytes(run_entry_bytes);
+                address_runs.emplace(current_run.base, current_run);
+            }
+            current_run.count = 0;
+        }
+
+        //! Associates the pointer value with the next pointer-id
+        void trackPointerValue(const void* value)
+        {
+            if (spilled_pointers.enabled()) {
+                budget.addPointer(sizeof(std::uint32_t));
+                spilled_pointers.push(reinterpret_cast<std::uintptr_t>(value), spilled_pointer_count++);
+            }
+            else {
+                budget.addPointer(sizeof(std::uint32_t) + sizeof(const void*));
+                raw_ptr_values.push_back(value);
+            }
+        }
+
+        //! Associates the object memory address with the object-id, outside of runs
+        void trackObjectId(std::uintptr_t address, std::uint32_t id)
+        {
+            if (spilled_objects.enabled()) {
+                spilled_objects.push(address, id);
+            }
+            else if (backend == CRPSBackend::SortedLog) {
+                budget.addBytes(sizeof(detail::SpillEntry));
+                object_log.push_back(detail::SpillEntry{ address, id });
+            }
+            else {
+                budget.addBytes(object_entry_bytes);
+                obj_ptr_to_id[reinterpret_cast<const void*>(address)] = id;
+                if (automatic_backend && obj_ptr_to_id.size() * object_entry_bytes >= index_cache_bytes) {
+                    sampleBackend();
+                }
+            }
+        }
+
+        /*! Chooses the backend from the objects and pointers tracked so far, and from the size of the index. 
+            The Hash backend is sampled again once the object count doubles, and once its index reaches 
+            index_cache_bytes. The SortedLog backend is kept. 
+            */
+        void sampleBackend()
+        {
+            backend_sampled = true;
+            next_backend_sample = 2 * map_insert_count;
+
+            const std::size_t pointers = spilled_pointers.enabled() ? spilled_pointer_count : raw_ptr_values.size();
+            const std::size_t indexed = obj_ptr_to_id.size() - 1;
+            if (100 * pointers >= dense_pointer_percent * indexed && indexed * object_entry_bytes < index_cache_bytes) {
+                return;
+            }
+            automatic_backend = false;
+            useBackend(CRPSBackend::SortedLog);
+        }
+
+        //! Moves the objects stored in the current backend to the selected backend
+        void useBackend(CRPSBackend selected)
+        {
+            if (selected == backend) {
+                return;
+            }
+            if (selected == CRPSBackend::SortedLog)
+            {
+                object_log.reserve(obj_ptr_to_id.size());
+                for (auto const& entry : obj_ptr_to_id) {
+                    object_log.push_back(detail::SpillEntry{ reinterpret_cast<std::uintptr_t>(entry.first), entry.second });
+                }
+                std::unordered_map<const void*, std::uint32_t>().swap(obj_ptr_to_id);
+            }
+            else
+            {
+                prepareLookups();
+                for (auto const& entry : object_log) {
+                    obj_ptr_to_id[reinterpret_cast<const void*>(entry.address)] = entry.id;
+                }
+                std::vector<detail::SpillEntry>().swap(object_log);
+                sorted_log_size = 0;
+            }
+            backend = selected;
+        }
+
+        /*! Creates pointer_id_to_object_id map by merging the sorted runs of pointer values 
+            with the sorted runs of object addresses, in ascending address order. 
+
+            @throws CRPSException If a pointer value is not the address of an object visited by the traversal. 
+            */
+        std::vector<std::uint32_t> resolveSpilledPointers() const
+        {
+            spilled_objects.spill();
+            spilled_pointers.spill();
+
+            std::vector<std::uint32_t> raw_to_obj(spilled_pointer_count);
+            detail::SpillMerge objects(spilled_objects);
+            detail::SpillMerge pointers(spilled_pointers);
+
+            detail::SpillEntry object{};
+            detail::SpillEntry latest{};
+            bool has_object = objects.next(object);
+            bool has_latest = false;
+
+            std::vector<std::pair<std::uint32_t, std::uint32_t>> member_offsets{};
+            detail::SpillEntry pointer;
+            while (pointers.next(pointer))
+            {
+                while (has_object && object.address <= pointer.address) {
+                    latest = object;
+                    has_latest = true;
+                    has_object = objects.next(object);
+                }
+
+                const void* value = reinterpret_cast<const void*>(pointer.address);
+                std::uint32_t id;
+                bool found = findTrackedObject(value, id);
+                if (has_latest && latest.address == pointer.address && (!found || latest.id > id)) {
+                    id = latest.id;
+                    found = true;
+                }
+
+                std::uint32_t offset;
+                if (!found && !findSplicedObject(value, id) && !findExternalObject(value, id)) 
+                {
+                    if (!findMemberObject(value, id, offset))
+                    {
+                        std::ostringstream address{};
+                        address << value;
+                        throw CRPSException("Memory address " + address.str() + " not found in serialization traversal");
+                    }
+                    member_offsets.emplace_back(pointer.id, offset);
+                }
+                raw_to_obj[pointer.id] = id;
+            }
+
+            // the offsets of pointers to members follow the map, in pointer order
+            std::sort(member_offsets.begin(), member_offsets.end());
+            for (auto const& member : member_offsets) {
+                raw_to_obj.push_back(member.second);
+            }
+            return raw_to_obj;
+        }
+
+        //! True if the memory range of run intersects the memory range of a stored run
+        bool overlapsStoredRun(detail::AddressRun const& run) const
+        {
+            auto next = address_runs.lower_bound(run.base);
+            if (next != address_runs.end() && next->first <= run.last()) {
+                return true;
+            }
+            return next != address_runs.begin() && std::prev(next)->second.last() >= run.base;
+        }
+
+        //! Finds the object-id of the latest object tracked at address by this mapper
+        bool findTrackedObject(const void* address, std::uint32_t& id) const
+        {
+            bool found = false;
+            const std::uintptr_t run_address = reinterpret_cast<std::uintptr_t>(address);
+
+            if (backend == CRPSBackend::SortedLog)
+            {
+                auto entry = std::upper_bound(object_log.begin(), object_log.begin() + static_cast<std::ptrdiff_t>(sorted_log_size), 
+                    detail::SpillEntry{ run_address, std::numeric_limits<std::uint32_t>::max() });
+                if (entry != object_log.begin() && (--entry)->address == run_address) {
+                    id = entry->id;
+                    found = true;
+                }
+            }
+            else
+            {
+                auto it = obj_ptr_to_id.find(address);
+                if (it != obj_ptr_to_id.end()) {
+                    id = it->second;
+                    found = true;
+                }
+            }
+
+            std::uint32_t run_id;
+
+            if (!address_runs.empty())
+            {
+                auto run = address_runs.upper_bound(run_address);
+                if (run != address_runs.begin() && std::prev(run)->second.find(run_address, run_id) && (!found || run_id > id)) {
+                    id = run_id;
+                    found = true;
+                }
+            }
+            if (current_run.find(run_address, run_id) && (!found || run_id > id)) {
+                id = run_id;
+                found = true;
+            }
+            return found;
+        }
+
+        //! Finds the object-id of the latest object tracked at address, including spliced fragments, unless forgotten
+        bool findObject(const void* address, std::uint32_t& id) const
+        {
+            return (findTrackedObject(address, id) || findSplicedObject(address, id)) && (id == 0 || id >= forgotten_ids);
+        }
+
+        /*! Finds the object-id of the latest object tracked at address by a spliced fragment. 
+            Only the fragments with a span containing address are searched, found by a binary 
+            search of the spans sorted by their lowest object, and by walking back while the 
+            reach of the spans before them includes address. 
+            */
+        bool findSplicedObject(const void* address, std::uint32_t& id) const
+        {
+            if (address == nullptr) {
+                return false;
+            }
+            const std::uintptr_t spliced_address = reinterpret_cast<std::uintptr_t>(address);
+            bool found = false;
+
+            auto range = std::upper_bound(spliced_ranges.begin(), spliced_ranges.end(), detail::SplicedRange{ spliced_address, 0, 0, 0 });
+            while (range != spliced_ranges.begin() && (--range)->reach >= spliced_address)
+            {
+                auto const& fragment = spliced_fragments[range->fragment];
+                std::uint32_t fragment_id;
+                if (range->highest >= spliced_address && fragment.second->findObject(address, fragment_id) && (!found || fragment.first + fragment_id > id)) {
+                    id = fragment.first + fragment_id;
+                    found = true;
+                }
+            }
+            return found;
+        }
+
+        /*! Finds the object-id of the latest blit array element containing address, in this mapper 
+            or in a spliced fragment, flagged with member_object_flag, and the offset of address in 
+            the element. Called for the pointers whose value is not the address of an object. 
+            */
+        bool findMemberObject(const void* address, std::uint32_t& id, std::uint32_t& offset) const
+        {
+            const std::uintptr_t member_address = reinterpret_cast<std::uintptr_t>(address);
+            bool found = false;
+
+            auto range = blit_ranges.upper_bound(member_address);
+            if (range != blit_ranges.begin())
+            {
+                detail::AddressRun const& run = std::prev(range)->second;
+                const std::uintptr_t distance = member_address - run.base;
+                if (run.stride != 0 && distance / run.stride < run.count) {
+                    id = run.first_id + static_cast<std::uint32_t>(distance / run.stride);
+                    offset = static_cast<std::uint32_t>(distance % run.stride);
+                    found = true;
+                }
+            }
+
+            auto spliced = std::upper_bound(spliced_ranges.begin(), spliced_ranges.end(), detail::SplicedRange{ member_address, 0, 0, 0 });
+            while (spliced != spliced_ranges.begin() && (--spliced)->reach >= member_address)
+            {
+                auto const& fragment = spliced_fragments[spliced->fragment];
+                std::uint32_t fragment_id;
+                std::uint32_t fragment_offset;
+                if (spliced->highest >= member_address && fragment.second->findMemberObject(address, fragment_id, fragment_offset)) 
+                {
+                    fragment_id = fragment.first + (fragment_id & ~detail::member_object_flag);
+                    if (!found || fragment_id > id) {
+                        id = fragment_id;
+                        offset = fragment_offset;
+                        found = true;
+                    }
+                }
+            }
+
+            if (!found || id < forgotten_ids) {
+                return false;
+            }
+            id |= detail::member_object_flag;
+            return true;
+        }
+
+    private:
+        std::unordered_map<const void*, std::uint32_t> obj_ptr_to_id{}; //!< Associates object memory address with object-id, for objects not stored in runs, with the Hash backend
+
+        mutable std::vector<detail::SpillEntry> object_log{}; //!< Object memory addresses and object-ids, for objects not stored in runs, with the SortedLog backend
+
+        mutable std::size_t sorted_log_size{}; //!< Number of leading entries of object_log that are sorted
+
+        CRPSBackend backend{ CRPSBackend::Hash }; //!< Index of the objects not stored in runs
+
+        bool automatic_backend{ true }; //!< True if backend is chosen once backend_sample_size objects are tracked
+
+        bool backend_sampled{ false }; //!< True if backend was chosen by sampling
+
+        std::uint32_t next_backend_sample{ backend_sample_size }; //!< Object count from which the automatic backend is sampled next
+
+        std::size_t deferment_count{ 0 }; //!< Number of objects of cereal::defer serialized
+
+        static const std::uint32_t backend_sample_size = 4096; //!< Number of objects tracked before the backend is chosen
+
+        static const std::size_t dense_pointer_percent = 90; //!< Pointers per hundred objects stored in the index, from which the Hash backend is chosen
+
+        static const std::size_t index_cache_bytes = std::size_t(4) << 20; //!< Estimated bytes of the Hash index from which it exceeds a typical last-level cache, and the SortedLog backend is chosen
+
+        std::map<std::uintptr_t, detail::AddressRun> address_runs{}; //!< Non-overlapping runs of objects, by memory address of their first object
+
+        std::map<std::uintptr_t, detail::AddressRun> blit_ranges{}; //!< Latest range tracked by trackRange at each memory address, in which pointers to members of the elements are found
+
+        detail::AddressRun current_run{ 0, 0, 0, 0 }; //!< Run of the most recently tracked objects, which may still be extended
+
+        static const std::uint32_t min_stored_run = 16; //!< Objects of a run from which it is stored in address_runs instead of the index
+
+        static const std::uintptr_t max_run_stride = 4096; //!< Distance in bytes between objects from which they do not form a run, as they are rarely elements of one array
+
+        std::uint32_t map_insert_count{}; //!< Next available object-id
+
+        std::uint32_t forgotten_ids{}; //!< Object-id from which objects are found, set by forgetObjects
+
+        std::uint32_t erased_ids{}; //!< Object-id below which the entries of forgotten objects are erased
+
+        std::vector<const void*> raw_ptr_values{}; //!< Associates pointer value to pointer-id
+
+        mutable detail::SpillRuns spilled_objects{}; //!< Object addresses and object-ids outside of runs, if spilled to temporary files
+
+        mutable detail::SpillRuns spilled_pointers{}; //!< Pointer values and pointer-ids, if spilled to temporary files
+
+        std::uint32_t spilled_pointer_count{}; //!< Next available pointer-id, if pointers are spilled
+
+        static const std::size_t object_entry_bytes = sizeof(std::pair<const void* const, std::uint32_t>) + 3 * sizeof(void*); //!< Estimated bytes of an obj_ptr_to_id node and bucket
+        static const std::size_t run_entry_bytes = sizeof(std::pair<const std::uintptr_t, detail::AddressRun>) + 4 * sizeof(void*); //!< Estimated bytes of an address_runs node
+
+        detail::BookkeepingBudget budget{}; //!< Counts the book-keeping against the limits set by setLimits
+
+        std::vector<std::pair<std::uint32_t, std::shared_ptr<const CRPSOutputMapper>>> spliced_fragments{}; //!< Fragments with the object-id preceding their first object
+
+        mutable std::vector<detail::SplicedRange> spliced_ranges{}; //!< Address spans of the objects of the spliced fragments, sorted by prepareLookups
+
+        mutable bool spliced_ranges_sorted{ true }; //!< True if spliced_ranges is sorted and its reach is computed
+
+        mutable std::vector<std::pair<std::uintptr_t, std::uintptr_t>> object_spans{}; //!< Lowest and highest memory addresses of clusters of tracked objects, computed by prepareSplicing
+
+        mutable bool object_spans_prepared{ false }; //!< True if object_spans is computed
+
+        static const std::uintptr_t max_span_gap = 256; //!< Distance in bytes between objects from which they are split into separate spans, as they are rarely parts of one object
+
+        std::size_t archive_registrations{}; //!< Number of shared pointers and polymorphic types registered by the traversal
+
+        ExternalObjects const* external_objects{ nullptr }; //!< Objects referenced by external object-id, if provided
+
+        bool completed{ false }; //!< True if pointer book-keeping is saved to user archive
+    };
+
+    // ######################################################################  
+    //! Performs pointer book-keeping when loading classes from an InputArchive. 
+    /*! This class is used by CRPSInputArchive to associate the memory address
+        of each object or pointer it encounters with a graph traversal id. 
+        CRPSInputArchive then provides this class with the user's archive to 
+        load book-keeping (in the form of a pointer-id to object-id map) to 
+        initialize the pointers. 
+
+        @internal */
+    class CRPSInputMapper : public cereal::OutputArchive<CRPSInputMapper, cereal::AllowEmptyClassElision>, public detail::CRPSMapperCore
+    {
+    public:
+
+        //! Empty object_id_to_object_address map associates an object-id of 0 to a memory address of nullptr 
+        CRPSInputMapper() :
+            OutputArchive<CRPSInputMapper, cereal::AllowEmptyClassElision>(this)
+        {
+            obj_ptrs.push_back(nullptr);
+        }
+
+        /*! Loads pointer_id_to_object_id map from input_archive.
+            Performs defered pointer initializations (with pointers/objects tracked in traversal) using pointer_id_to_object_id map. 
+
+            @param input_archive A copy of the users's input_archive reference stored in the CRPSInputArchive 
+            */
+        template <class Archive>
+        void complete(Archive& input_archive)
+        {
+            completePointers(loadPointerTable(input_archive));
+        }
+
+        /*! Loads pointer_id_to_object_id map from input_archive. 
+
+            @param input_archive A copy of the users's input_archive reference stored in the CRPSInputArchive 
+            */
+        template <class Archive>
+        std::vector<std::uint32_t> loadPointerTable(Archive& input_archive)
+        {
+            std::vector<std::uint32_t> raw_to_obj{};
+            detail::BoundedTable table{ raw_to_obj, raw_ptrs.size() };
+            input_archive(table);
+            return raw_to_obj;
+        }
+
+        //! Number of pointers tracked so far, which is the size of their pointer_id_to_object_id map
+        std::size_t pointerCount() const
+        {
+            return raw_ptrs.size();
+        }
+
+        /*! Performs defered pointer initializations using pointer_id_to_object_id map, 
+            then retains or releases the tables. Does not access the user's archive. 
+            */
+        void completePointers(std::vector<std::uint32_t> raw_to_obj)
+        {
+            restoreTable(raw_to_obj);
+            if (placement_arena != nullptr) {
+                placeObjects(raw_to_obj);
+            }
+
+            if (retain_tables) {
+                retainTables(raw_to_obj);
+            }
+            releaseTables();
+        }
+
+        /*! Performs defered pointer initializations (with pointers/objects tracked in traversal) using pointer_id_to_object_id map. 
+
+            @param raw_to_obj A pointer_id_to_object_id map, as created by CRPSOutputMapper::pointerTable 
+            @throws CRPSException If the map does not match the pointers/objects tracked in traversal. 
+            */
+        void restorePointers(std::vector<std::uint32_t> raw_to_obj)
+        {
+            restoreTable(raw_to_obj);
+        }
+
+        //! Initialize pointers with external object-ids to the objects tracked by objects
+        void setExternalObjects(ExternalObjects const& objects)
+        {
+            external_objects = &objects;
+        }
+
+        //! Keep a compact pointer table and the addresses of its targets after complete, as required by relocate
+        void setRetainTables(bool retain)
+        {
+            retain_tables = retain;
+        }
+
+        //! Counts an object of cereal::defer, called before the deferment is queued
+        void trackDeferment()
+        {
+            deferment_count++;
+        }
+
+        //! Number of objects of cereal::defer serialized so far
+        std::size_t deferments() const
+        {
+            return deferment_count;
+        }
+
+        /*! Only write pointers whose value changes, as the pointers are initialized by a previous load. 
+            @throws CRPSException If pointers were already tracked, as those keep the previous setting. */
+        void setInPlace(bool reload)
+        {
+            if (!raw_ptrs.empty()) {
+                throw CRPSException("setInPlace must be called before any pointer is loaded");
+            }
+            in_place = reload;
+        }
+
+        //! Move objects of placed_ptr into arena in order, once pointers are initialized, or disable placement if arena is nullptr
+        void setPlacement(PlacementArena* arena, PlacementOrder order)
+        {
+            placement_arena = arena;
+            placement_order = order;
+        }
+
+        //! Registers the object of a placed_ptr for placement, unless it is empty or already placed
+        template <class T> inline
+        void trackPlacement(placed_ptr<T>& ptr)
+        {
+            // only a placed_ptr given its deleter by this arena may own an object of the arena
+            if (placement_arena == nullptr || !ptr || (ptr.get_deleter().arena == placement_arena && placement_arena->contains(ptr.get()))) {
+                return;
+            }
+            budget.addBytes(sizeof(detail::Placement));
+            placements.push_back(detail::Placement{ std::addressof(ptr), ptr.get(), sizeof(T), &detail::place_object<T> });
+        }
+
+        /*! Repatches pointers after objects are moved from one memory region to another. 
+            Pointers into the moved region are rewritten, and the retained tables are updated 
+            for pointers and targets located in the moved region. 
+
+            @param old_base The start of the memory region before the move
+            @param new_base The start of the memory region after the move
+            @param bytes The size of the memory region
+            @throws CRPSException If tables were not retained by complete. 
+            */
+        void relocate(const void* old_base, void* new_base, std::size_t bytes)
+        {
+            if (!tables_retained) {
+                throw CRPSException("Relocation requires the pointer and object tables to be retained by complete");
+            }
+
+            const std::uintptr_t old_begin = reinterpret_cast<std::uintptr_t>(old_base);
+            const std::uintptr_t new_begin = reinterpret_cast<std::uintptr_t>(new_base);
+            auto moved = [&](void* address) { return reinterpret_cast<std::uintptr_t>(address) - old_begin < bytes; };
+            auto relocated = [&](void* address) { return reinterpret_cast<void*>(reinterpret_cast<std::uintptr_t>(address) - old_begin + new_begin); };
+
+            for (detail::RetainedPointer& pointer : retained_pointers)
+            {
+                if (moved(pointer.raw)) {
+                    pointer.raw = relocated(pointer.raw);
+                }
+                void* target = retained_targets[pointer.target];
+                if (moved(target)) {
+                    pointer.assign(pointer.raw, relocated(target));
+                }
+            }
+            for (void*& target : retained_targets)
+            {
+                if (moved(target)) {
+                    target = relocated(target);
+                }
+            }
+        }
+
+        //! Throws a CRPSException from the traversal once its book-keeping exceeds limits
+        void setLimits(CRPSLimits const& limits)
+        {
+            budget.setLimits(limits);
+        }
+
+        //! Associate the object id to the object memory address.
+        template <class T> inline
+        void trackAddress(T& t)
+        {
+            detail::check_object_ids(objectCount(), 1);
+            budget.addObjects(1, sizeof(void*));
+            obj_ptrs.push_back(std::addressof(t));
+        }
+
+        //! Associate the pointer id to the pointer's memory address, and track it as an object
+        template <class T> inline
+        void trackPointer(T*& p)
+        {
+            budget.addPointer(sizeof(void*) + sizeof(detail::PointerAssign) + sizeof(std::uint32_t));
+            raw_ptrs.push_back(std::addressof(p));
+            deferedPtrLoads.push_back(in_place ? &detail::assign_changed_pointer<T> : &detail::assign_pointer<T>);
+
+            trackAddress(p);
+        }
+
+        /*! Associate each of count elements of stride bytes, starting at data, with the next object id. 
+            @throws CRPSException If the elements exceed the available object-ids. 
+            */
+        void trackRange(void* data, std::size_t stride, std::size_t count)
+        {
+            if (count == 0) {
+                return;
+            }
+            const std::uint32_t first_id = objectCount();
+            detail::check_object_ids(first_id, count);
+            budget.addObjects(1, sizeof(detail::AddressRange));
+
+            const std::uint32_t range_ids = (byte_ranges.empty() ? erased_range_ids : byte_ranges.back().range_ids) + static_cast<std::uint32_t>(count);
+            byte_ranges.push_back(detail::AddressRange{ first_id, static_cast<std::uint32_t>(count), range_ids, stride, data });
+        }
+
+        //! Number of object-ids tracked so far
+        std::uint32_t objectCount() const
+        {
+            return static_cast<std::uint32_t>(obj_ptrs.size()) + erased_objects + (byte_ranges.empty() ? erased_range_ids : byte_ranges.back().range_ids);
+        }
+
+        /*! Discards the pointers tracked so far, once they are initialized by restorePointers. 
+            Objects remain tracked, so pointers tracked later may still reference them. 
+            */
+        void releasePointers()
+        {
+            raw_ptrs.clear();
+            deferedPtrLoads.clear();
+            budget.releasePointers();
+        }
+
+        /*! Throws a CRPSException from restorePointers for pointers to objects with an object-id below 
+            first_id. Their addresses are erased once at least half of the tracked objects are forgotten, 
+            so erasing costs a constant per object. 
+            */
+        void forgetObjects(std::uint32_t first_id)
+        {
+            forgotten_ids = std::max(forgotten_ids, first_id);
+            const std::uint32_t count = objectCount();
+            if (2 * (forgotten_ids - erased_ids) < count - erased_ids) {
+                return;
+            }
+
+            // ranges entirely below forgotten_ids are erased, with the object-ids of ranges before forgotten_ids
+            std::uint32_t forgotten_range_ids = erased_range_ids;
+            auto range = byte_ranges.begin();
+            for (; range != byte_ranges.end() && range->first_id < forgotten_ids; ++range) {
+                forgotten_range_ids = range->range_ids - range->count + std::min(range->count, forgotten_ids - range->first_id);
+            }
+            auto erased_range = byte_ranges.begin();
+            while (erased_range != byte_ranges.end() && erased_range->first_id + erased_range->count <= forgotten_ids) {
+                erased_range_ids = (erased_range++)->range_ids;
+            }
+            const std::size_t erased_range_count = static_cast<std::size_t>(erased_range - byte_ranges.begin());
+            byte_ranges.erase(byte_ranges.begin(), erased_range);
+
+            // addresses of the object-ids below forgotten_ids that are not in ranges, except nullptr
+            const std::uint32_t forgotten_objects = forgotten_ids - forgotten_range_ids - 1;
+            obj_ptrs.erase(obj_ptrs.begin() + 1, obj_ptrs.begin() + 1 + (forgotten_objects - erased_objects));
+
+            budget.releaseObjects(forgotten_objects - erased_objects + erased_range_count, 
+                (forgotten_objects - erased_objects) * sizeof(void*) + erased_range_count * sizeof(detail::AddressRange));
+            erased_objects = forgotten_objects;
+            erased_ids = forgotten_ids;
+        }
+
+    private:
+
+        /*! Performs defered pointer initializations using pointer_id_to_object_id map, once its member offsets 
+            are split off by splitMembers, which leaves an entry per pointer in raw_to_obj. 
+            @throws CRPSException If the map does not match the pointers/objects tracked in traversal. 
+            */
+        void restoreTable(std::vector<std::uint32_t>& raw_to_obj)
+        {
+            CRPS_TRACE_SCOPE("fixup");
+            CRPS_TRACE_COUNTS(objectCount(), raw_to_obj.size());
+            splitMembers(raw_to_obj);
+
+            for (std::size_t i = 0; i < raw_ptrs.size(); i++)
+            {
+                if (raw_to_obj[i] & detail::external_object_flag)
+                {
+                    deferedPtrLoads[i](raw_ptrs[i], externalObject(raw_to_obj[i] & ~detail::external_object_flag, i));
+                    continue;
+                }
+                const bool member = (raw_to_obj[i] & detail::member_object_flag) != 0;
+                const std::uint32_t id = member ? member_targets[raw_to_obj[i] & ~detail::member_object_flag].id : raw_to_obj[i];
+                if (id >= objectCount())
+                {
+                    std::ostringstream address{};
+                    address << raw_ptrs[i];
+                    throw CRPSException("Pointer at memory address " + address.str() + " has object index exceeding object traversal count");
+                }
+                if (id != 0 && id < forgotten_ids)
+                {
+                    std::ostringstream address{};
+                    address << raw_ptrs[i];
+                    throw CRPSException("Pointer at memory address " + address.str() + " references a forgotten object");
+                }
+                if (member && member_targets[raw_to_obj[i] & ~detail::member_object_flag].offset >= elementStride(id))
+                {
+                    std::ostringstream address{};
+                    address << raw_ptrs[i];
+                    throw CRPSException("Pointer at memory address " + address.str() + " has member offset exceeding its blit array element");
+                }
+                deferedPtrLoads[i](raw_ptrs[i], objectAddress(raw_to_obj[i]));
+            }
+        }
+
+        /*! Moves the offsets of pointers to members, which follow the entry per pointer, into member_targets, 
+            and replaces the flagged object-id of each such pointer by member_object_flag and the index of its target. 
+            @throws CRPSException If the offsets do not match the flagged entries. 
+            */
+        void splitMembers(std::vector<std::uint32_t>& raw_to_obj)
+        {
+            const std::size_t count = raw_ptrs.size();
+            auto mismatch = []() { return CRPSException("Size of raw_ptr_to_obj_id map loaded from input archive does not match size of map generated from traversal"); };
+            if (raw_to_obj.size() < count) {
+                throw mismatch();
+            }
+
+            std::size_t next = count;
+            member_targets.clear();
+            for (std::size_t i = 0; i < count; i++)
+            {
+                if (!detail::is_member_object(raw_to_obj[i])) {
+                    continue;
+                }
+                if (next == raw_to_obj.size()) {
+                    throw mismatch();
+                }
+                member_targets.push_back(detail::MemberTarget{ raw_to_obj[i] & ~detail::member_object_flag, raw_to_obj[next++] });
+                raw_to_obj[i] = detail::member_object_flag | static_cast<std::uint32_t>(member_targets.size() - 1);
+            }
+            if (next != raw_to_obj.size()) {
+                throw mismatch();
+            }
+            raw_to_obj.resize(count);
+        }
+
+        //! Size in bytes of the blit array element with the object-id, or 0 if the object is not in a range
+        std::size_t elementStride(std::uint32_t id) const
+        {
+            auto range = std::upper_bound(byte_ranges.begin(), byte_ranges.end(), id, 
+                [](std::uint32_t object_id, detail::AddressRange const& r) { return object_id < r.first_id; });
+            if (range == byte_ranges.begin() || id - (--range)->first_id >= range->count) {
+                return 0;
+            }
+            return range->stride;
+        }
+
+        /*! Memory address of the object with the object-id, which must be less than objectCount and not forgotten, 
+            or of the member of a blit array element, for member_object_flag and the index of the member target. 
+            */
+        void* objectAddress(std::uint32_t id) const
+        {
+            if (id & detail::member_object_flag) {
+                detail::MemberTarget const& target = member_targets[id & ~detail::member_object_flag];
+                return static_cast<char*>(objectAddress(target.id)) + target.offset;
+            }
+            if (byte_ranges.empty() || id < byte_ranges.front().first_id) {
+                return obj_ptrs[objectIndex(id, erased_range_ids)];
+            }
+
+            auto range = std::upper_bound(byte_ranges.begin(), byte_ranges.end(), id, 
+                [](std::uint32_t object_id, detail::AddressRange const& r) { return object_id < r.first_id; });
+            --range;
+
+            if (id - range->first_id < range->count) {
+                return static_cast<char*>(range->base) + range->stride * (id - range->first_id);
+            }
+            return obj_ptrs[objectIndex(id, range->range_ids)];
+        }
+
+        //! Index in obj_ptrs of the object-id outside of ranges, preceded by range_ids object-ids of ranges
+        std::uint32_t objectIndex(std::uint32_t id, std::uint32_t range_ids) const
+        {
+            return id == 0 ? 0 : id - range_ids - erased_objects;
+        }
+
+        /*! Moves the objects of the registered placed_ptr into the arena, in the placement order. 
+            Pointers located in or referencing a moved object are rewritten, as are the tables. 
+            */
+        void placeObjects(std::vector<std::uint32_t> const& raw_to_obj)
+        {
+            const std::size_t count = placements.size();
+            if (count == 0) {
+                return;
+            }
+
+            std::vector<std::size_t> by_address(count);
+            std::iota(by_address.begin(), by_address.end(), std::size_t{ 0 });
+            std::sort(by_address.begin(), by_address.end(), 
+                [&](std::size_t a, std::size_t b) { return std::less<const void*>()(placements[a].object, placements[b].object); });
+
+            // index of the placement whose object contains address, or count if none does
+            auto containing = [&](const void* address) -> std::size_t {
+                auto next = std::upper_bound(by_address.begin(), by_address.end(), address, 
+                    [&](const void* a, std::size_t i) { return std::less<const void*>()(a, placements[i].object); });
+                if (next == by_address.begin()) {
+                    return count;
+                }
+                --next;
+                const std::uintptr_t offset = reinterpret_cast<std::uintptr_t>(address) - reinterpret_cast<std::uintptr_t>(placements[*next].object);
+                return offset < placements[*next].size ? *next : count;
+            };
+
+            std::vector<std::size_t> order(count);
+            std::iota(order.begin(), order.end(), std::size_t{ 0 });
+            if (placement_order == PlacementOrder::BreadthFirst) {
+                order = breadthFirstPlacements(raw_to_obj, containing);
+            }
+
+            // old begin of each moved object, with its old end and new begin
+            std::map<std::uintptr_t, std::pair<std::uintptr_t, std::uintptr_t>> moved{};
+            auto translate = [&](void* address) -> void* {
+                const std::uintptr_t value = reinterpret_cast<std::uintptr_t>(address);
+                auto range = moved.upper_bound(value);
+                if (range == moved.begin() || value >= (--range)->second.first) {
+                    return address;
+                }
+                return reinterpret_cast<void*>(value - range->first + range->second.second);
+            };
+
+            for (std::size_t i : order)
+            {
+                detail::Placement const& placement = placements[i];
+                void* storage = placement.place(translate(placement.owner), *placement_arena);
+
+                const std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(placement.object);
+                const std::uintptr_t placed = reinterpret_cast<std::uintptr_t>(storage);
+                moved.emplace(begin, std::make_pair(begin + placement.size, placed));
+            }
+
+            for (std::size_t i = 0; i < raw_ptrs.size(); i++)
+            {
+                raw_ptrs[i] = translate(raw_ptrs[i]);
+                if (raw_to_obj[i] & detail::external_object_flag) {
+                    continue;
+                }
+                void* target = objectAddress(raw_to_obj[i]);
+                void* placed = translate(target);
+                if (placed != target) {
+                    deferedPtrLoads[i](raw_ptrs[i], placed);
+                }
+            }
+            for (auto& address : obj_ptrs) {
+                address = translate(address);
+            }
+            for (auto& range : byte_ranges) {
+                range.base = translate(range.base);
+            }
+
+            std::vector<detail::Placement>().swap(placements);
+        }
+
+        /*! Orders placements breadth-first from each placement whose owner is not in a placed object, 
+            in traversal order. Edges lead from a placed object to the objects it owns, and to the placed 
+            objects referenced by pointers located in it. 
+            */
+        template <class Containing>
+        std::vector<std::size_t> breadthFirstPlacements(std::vector<std::uint32_t> const& raw_to_obj, Containing const& containing) const
+        {
+            const std::size_t count = placements.size();
+
+            std::vector<std::pair<std::size_t, std::size_t>> edges{};
+            std::vector<bool> owned(count, false);
+            for (std::size_t i = 0; i < count; i++)
+            {
+                const std::size_t owner = containing(placements[i].owner);
+                if (owner != count) {
+                    edges.emplace_back(owner, i);
+                    owned[i] = true;
+                }
+            }
+            for (std::size_t i = 0; i < raw_ptrs.size(); i++)
+            {
+                if (raw_to_obj[i] & detail::external_object_flag) {
+                    continue;
+                }
+                const std::size_t from = containing(raw_ptrs[i]);
+                const std::size_t to = from == count ? count : containing(objectAddress(raw_to_obj[i]));
+                if (to != count && to != from) {
+                    edges.emplace_back(from, to);
+                }
+            }
+            std::sort(edges.begin(), edges.end());
+            edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+            std::vector<std::size_t> first_edge(count + 1, 0);
+            for (auto const& edge : edges) {
+                ++first_edge[edge.first + 1];
+            }
+            std::partial_sum(first_edge.begin(), first_edge.end(), first_edge.begin());
+
+            std::vector<std::size_t> order{};
+            order.reserve(count);
+            std::vector<bool> visited(count, false);
+            for (std::size_t root = 0; root < count; root++)
+            {
+                if (owned[root] || visited[root]) {
+                    continue;
+                }
+                std::size_t next = order.size();
+                order.push_back(root);
+                visited[root] = true;
+
+                while (next < order.size())
+                {
+                    const std::size_t from = order[next++];
+                    for (std::size_t e = first_edge[from]; e < first_edge[from + 1]; e++)
+                    {
+                        if (!visited[edges[e].second]) {
+                            visited[edges[e].second] = true;
+                            order.push_back(edges[e].second);
+                        }
+                    }
+                }
+            }
+            return order;
+        }
+
+        /*! Keeps the pointers with an internal, non-null target, and the address of each distinct 
+            target, as required by relocate. The object tables are not retained. 
+            */
+        void retainTables(std::vector<std::uint32_t> const& raw_to_obj)
+        {
+            auto retained = [&](std::uint32_t id) { return id != 0 && !(id & detail::external_object_flag); };
+
+            std::vector<std::uint32_t> targets{};
+            for (std::uint32_t id : raw_to_obj)
+            {
+                if (retained(id)) {
+                    targets.push_back(id);
+                }
+            }
+            std::sort(targets.begin(), targets.end());
+            targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+
+            retained_targets.clear();
+            retained_targets.reserve(targets.size());
+            for (std::uint32_t id : targets) {
+                retained_targets.push_back(objectAddress(id));
+            }
+
+            retained_pointers.clear();
+            retained_pointers.reserve(raw_to_obj.size());
+            for (std::size_t i = 0; i < raw_to_obj.size(); i++)
+            {
+                if (retained(raw_to_obj[i])) {
+                    const auto target = std::lower_bound(targets.begin(), targets.end(), raw_to_obj[i]) - targets.begin();
+                    retained_pointers.push_back(detail::RetainedPointer{ raw_ptrs[i], deferedPtrLoads[i], static_cast<std::uint32_t>(target) });
+                }
+            }
+            tables_retained = true;
+        }
+
+        //! Releases the memory of the tables once the pointers are initialized
+        void releaseTables()
+        {
+            std::vector<void*>().swap(obj_ptrs);
+            std::vector<detail::AddressRange>().swap(byte_ranges);
+            std::vector<void*>().swap(raw_ptrs);
+            std::vector<detail::PointerAssign>().swap(deferedPtrLoads);
+            std::vector<detail::MemberTarget>().swap(member_targets);
+            budget.clear();
+        }
+
+        /*! Memory address of the external object with the object-id. 
+            @throws CRPSException If no external objects are provided, or if id exceeds their count. 
+            */
+        void* externalObject(std::uint32_t id, std::size_t pointer_id) const
+        {
+            if (external_objects == nullptr) {
+                throw CRPSException("Input archive references external objects, but no ExternalObjects were provided");
+            }
+            if (id >= external_objects->size())
+            {
+                std::ostringstream address{};
+                address << raw_ptrs[pointer_id];
+                throw CRPSException("Pointer at memory address " + address.str() + " has external object index exceeding external object count");
+            }
+            return external_objects->objectAddress(id);
+        }
+
+    private:
+        std::vector<void*> obj_ptrs{}; //!< Associates object-id with an object's memory address, for objects not in byte_ranges
+
+        std::vector<detail::AddressRange> byte_ranges{}; //!< Arrays tracked with one object-id per element, by first object-id
+
+        std::vector<void*> raw_ptrs{}; //!< Associates pointer-id with a pointer's memory address
+        std::vector<detail::PointerAssign> deferedPtrLoads{}; //!< Type-specific pointer initialization functions
+
+        std::vector<detail::MemberTarget> member_targets{}; //!< Targets of the pointers to members of blit array elements, split from the map by splitMembers
+
+        ExternalObjects const* external_objects{ nullptr }; //!< Objects referenced by external object-id, if provided
+
+        std::vector<detail::RetainedPointer> retained_pointers{}; //!< Pointers to internal objects, if retained by complete
+
+        std::vector<void*> retained_targets{}; //!< Addresses of the distinct objects referenced by retained_pointers
+
+        detail::BookkeepingBudget budget{}; //!< Counts the book-keeping against the limits set by setLimits
+
+        std::vector<detail::Placement> placements{}; //!< Objects of placed_ptr to be moved into placement_arena, in traversal order
+
+        PlacementArena* placement_arena{ nullptr }; //!< Arena objects of placed_ptr are moved into, if set
+
+        PlacementOrder placement_order{ PlacementOrder::BreadthFirst }; //!< Order objects are moved into placement_arena
+
+        bool retain_tables{ false }; //!< True if tables are kept after complete, otherwise they are released
+
+        bool tables_retained{ false }; //!< True once complete retained the tables for relocate
+
+        bool in_place{ false }; //!< True if pointers are only written when their value changes
+
+        bool completed{ false }; //!< True if defered pointer initialization is completed
+
+        std::uint32_t forgotten_ids{}; //!< Object-id from which pointers may reference objects, set by forgetObjects
+
+        std::uint32_t erased_ids{}; //!< Object-id below which the addresses of forgotten objects are erased
+
+        std::uint32_t erased_objects{}; //!< Addresses of forgotten objects outside of ranges erased from obj_ptrs, after nullptr
+
+        std::uint32_t erased_range_ids{}; //!< Object-ids of the ranges erased from byte_ranges
+
+        std::size_t deferment_count{ 0 }; //!< Number of objects of cereal::defer serialized
+    };
+
+    //! Counts the objects of cereal::defer serialized by CRPSOutputMapper, found by cereal through ADL
+    template <class T> inline
+    void prologue(CRPSOutputMapper& ar, cereal::DeferredData<T> const&)
+    {
+        ar.trackDeferment();
+    }
+
+    //! Counts the objects of cereal::defer serialized by CRPSInputMapper, found by cereal through ADL
+    template <class T> inline
+    void prologue(CRPSInputMapper& ar, cereal::DeferredData<T> const&)
+    {
+        ar.trackDeferment();
+    }
+
+    namespace detail
+    {
+        //! Calls the function object at function, for a task of MapperWorker
+        template <class Function> inline
+        void run_task(void* function)
+        {
+            (*static_cast<Function*>(function))();
+        }
+
+        //! A thread running the mapper traversals of CRPSOutputArchive::setConcurrentMapper, one at a time.
+        /*! The thread is started by the first task and reused by the later tasks, so a 
+            serialization costs two hand-offs between threads rather than a thread start. 
+            @internal */
+        class MapperWorker
+        {
+        public:
+            using Task = void (*)(void* context);
+
+            MapperWorker() = default;
+            MapperWorker(MapperWorker const&) = delete;
+            MapperWorker& operator=(MapperWorker const&) = delete;
+
+            //! Stops the thread, once the last task is waited for
+            ~MapperWorker()
+            {
+                if (!thread.joinable()) {
+                    return;
+                }
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    stopping = true;
+                }
+                task_posted.notify_one();
+                thread.join();
+            }
+
+            //! Runs run(context) on the thread, which must outlive the call to wait
+            void start(Task run, void* context)
+            {
+                if (!thread.joinable()) {
+                    thread = std::thread(&MapperWorker::runTasks, this);
+                }
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    task = run;
+                    task_context = context;
+                }
+                task_posted.notify_one();
+            }
+
+            //! Waits for the task of start, and rethrows its exception
+            void wait()
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                task_done.wait(lock, [this]() { return task == nullptr; });
+                if (failure)
+                {
+                    std::exception_ptr thrown = failure;
+                    failure = nullptr;
+                    lock.unlock();
+                    std::rethrow_exception(thrown);
+                }
+            }
+
+        private:
+
+            //! Runs posted tasks until stopped, run by the thread
+            void runTasks()
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                for (;;)
+                {
+                    task_posted.wait(lock, [this]() { return task != nullptr || stopping; });
+                    if (task == nullptr) {
+                        return;
+                    }
+                    const Task run = task;
+                    void* const context = task_context;
+                    lock.unlock();
+
+                    std::exception_ptr thrown{};
+                    try {
+                        run(context);
+                    }
+                    catch (...) {
+                        thrown = std::current_exception();
+                    }
+
+                    lock.lock();
+                    failure = thrown;
+                    task = nullptr;
+                    task_done.notify_one();
+                }
+            }
+
+        private:
+            std::thread thread{}; //!< Thread running the tasks, started by the first task
+
+            std::mutex mutex{}; //!< Guards the members below
+
+            std::condition_variable task_posted{}; //!< Signalled when a task is posted or stopping is set
+
+            std::condition_variable task_done{}; //!< Signalled when a task is done
+
+            Task task{ nullptr }; //!< Task posted and not yet done, or null
+
+            void* task_context{ nullptr }; //!< Argument of task
+
+            std::exception_ptr failure{}; //!< Exception of the last task, until rethrown by wait
+
+            bool stopping{ false }; //!< True once the thread is to stop
+        };
+    }
+
+    // ######################################################################
+    //! A wrapper that enables serializing raw pointers for output archives.    
+    /*! This class enables an archive to be used to serialize raw pointers 
+        that point to types co-serialized by the graph traversal. It provides 
+        an archive interface that wraps the interface of the provided user archive, 
+        to intercept objects and store their memory addresses.  
+
+        Upon ~CRPSOutputArchive or CRPSOutputArchive::complete, 
+        a vector used for mapping pointer indexes to object traversal indexes 
+        is passed into the user provided archive to be serialized. An exception 
+        is thrown if serialization is attempted after CRPSOutputArchive::complete. 
+
+        Additional user archives may be provided to write several formats in 
+        one save. Each archive receives every serialization call, while the 
+        pointer book-keeping is generated once and saved to every archive. 
+
+        @code{cpp}
+        cereal::BinaryOutputArchive binary_archive(binary_stream);
+        cereal::JSONOutputArchive json_archive(json_stream);
+        crps::CRPSOutputArchive<cereal::BinaryOutputArchive, cereal::JSONOutputArchive> crps_oarchive(binary_archive, json_archive);
+        @endcode
+         
+        Tracking addresses of BinaryData is not currently supported. 
+
+        @endcode */
+    template<class Archive, class ... Archives>
+    class CRPSOutputArchive
+    {
+    public:
+
+        /*! @param archive The archive provided by the user, its interface is wrapped for object tracking. 
+            @param tee_archives Additional archives provided by the user, which receive the same serialization calls as archive. */
+        CRPSOutputArchive(Archive& archive, Archives& ... tee_archives) : archive(archive), tee_archives(tee_archives...)
+        {
+            static_assert(detail::all_of<Archive::is_saving::value, Archives::is_saving::value...>::value, "CRPSOutputArchive<Archive> cannot be used with an input archive.");
+        }
+
+        /*! Complete defered action if not completed. */
+        ~CRPSOutputArchive()
+        {
+            complete();
+        }
+
+        /*! For OutputArchive: generates pointer book-keeping and saves book-keeping to output_archive, 
+            For InputArchive: loads book-keeping from input_archive and does defered pointer initialization. 
+
+            @throws CRPSException If pointer-booking serialization or defered pointer initialization fails. 
+        */
+        void complete()
+        {
+            if (slicing) {
+                complete_step(std::chrono::steady_clock::time_point::max());
+            }
+            if (!completed) {
+                beginComplete(std::launch::deferred);
+            }
+            finishComplete();
+        }
+
+        /*! Generates pointer book-keeping in slices, for callers that must not block for long. 
+            Each call continues generating the book-keeping until deadline, and saves it to the 
+            user archives once it is complete. 
+
+            Deferments, such as objects of cereal::defer, are serialized by the first call as a 
+            whole, and the deadline is only checked between chunks of pointers, so a call may 
+            overrun its deadline by the deferments or one chunk. Spilled book-keeping is 
+            generated by one call. 
+
+            @returns True once the book-keeping is saved
+            @throws CRPSException If pointer-booking serialization fails. 
+        */
+        bool complete_step(std::chrono::steady_clock::time_point deadline)
+        {
+            if (!completed) {
+                completed = true;
+                slicing = true;
+                serializeDeferments();
+            }
+            if (slicing)
+            {
+                if (!pointer_mapper.resolvePointers(sliced_table, deadline)) {
+                    return false;
+                }
+                slicing = false;
+
+                std::promise<std::vector<std::uint32_t>> table{};
+                table.set_value(std::move(sliced_table));
+                pending_table = table.get_future().share();
+            }
+            finishComplete();
+            return true;
+        }
+
+        /*! Generates pointer book-keeping on a worker thread, while the calling thread is free 
+            to flush or compress the output written so far. The user archive is not accessed 
+            until the returned future is waited on, which saves the book-keeping to the user 
+            archive on the calling thread. Otherwise, it is saved by complete or ~CRPSOutputArchive. 
+
+            @code{cpp}
+            std::future<void> completion = crps_oarchive.complete_async();
+            compress_payload(payload_stream);
+            completion.get();
+            @endcode
+
+            The returned future must not outlive the archive. If complete_step has started 
+            generating the book-keeping, the remaining steps continue on the worker thread. 
+
+            @throws CRPSException From the returned future, if pointer-booking serialization fails. 
+        */
+        std::future<void> complete_async()
+        {
+            if (slicing) {
+                slicing = false;
+                pending_table = std::async(std::launch::async, &CRPSOutputArchive::resolveRemainingPointers, this).share();
+            }
+            if (!completed) {
+                beginComplete(std::launch::async);
+            }
+            return std::async(std::launch::deferred, &CRPSOutputArchive::finishComplete, this);
+        }
+
+        /*! Saves pointers to objects of an external graph as external object-ids, 
+            instead of requiring the objects to be co-serialized. 
+
+            @param objects The ExternalObjects of the external graph, which must outlive the archive 
+            */
+        void setExternalObjects(ExternalObjects const& objects)
+        {
+            pointer_mapper.setExternalObjects(objects);
+        }
+
+        /*! Packs pointer book-keeping into one binary value for text archives, such as 
+            cereal::JSONOutputArchive and cereal::XMLOutputArchive, which encode it as base64 
+            instead of one element per pointer. Archives without binary values are unaffected. 
+            The archive must be loaded by a CRPSInputArchive with compact pointers set. 
+
+            The binary value stores the map in little-endian byte order on every platform. 
+            */
+        void setCompactPointers(bool compact)
+        {
+            compact_pointers = compact;
+        }
+
+        /*! Keeps pointer book-keeping within about budget bytes of memory, by spilling sorted runs 
+            of object addresses and pointer values to temporary files, which are merged by complete. 
+            Must be called before the first serialization. A budget of 0 disables spilling. 
+
+            The pointer-id to object-id map is created in memory, at 4 bytes per pointer. 
+            */
+        void setSpillBudget(std::size_t budget)
+        {
+            pointer_mapper.setSpillBudget(budget);
+        }
+
+        /*! Throws a CRPSException from the serialization that makes the pointer book-keeping 
+            exceed limits, before the book-keeping grows any further. 
+            */
+        void setLimits(CRPSLimits const& limits)
+        {
+            pointer_mapper.setLimits(limits);
+        }
+
+        /*! Selects the index of tracked objects, which is chosen automatically by default. 
+            Must be called before the first serialization to take effect from the start. 
+            */
+        void setBackend(CRPSBackend backend)
+        {
+            pointer_mapper.setBackend(backend);
+        }
+
+        /*! Runs the crps mapper traversal of each serialization on a worker thread, while the 
+            user archives write the same objects on the calling thread. Both traversals only read 
+            the objects, so save latency approaches the longer of the two instead of their sum. 
+            Each serialization joins the worker before it returns, so objects may be modified 
+            between serializations as usual. 
+
+            The serialize functions of the saved types must not modify shared state. The worker 
+            thread is started by the first serialization and reused by the later ones, each of which 
+            costs two hand-offs between the threads, so the option pays off for serializations of 
+            many objects rather than for many small serializations. 
+            */
+        void setConcurrentMapper(bool concurrent)
+        {
+            concurrent_mapper = concurrent;
+        }
+
+        //! Statistics of the pointer book-keeping, including the selected backend
+        CRPSMapperStats stats() const
+        {
+            return pointer_mapper.stats();
+        }
+
+        //! Forwards types to user archive and crps mapper. 
+        template <class ... Types> inline
+        CRPSOutputArchive& operator()(Types&& ... args)
+        {
+            handle(std::forward<Types>(args)...);
+            return *this;
+        }
+
+        //! This is a boost compatability layer.
+        template <class T> inline
+        CRPSOutputArchive& operator&(T&& arg)
+        {
+            handle(std::forward<T>(arg));
+            return *this;
+        }
+
+        //! This is a boost compatability layer.
+        template <class T> inline
+        CRPSOutputArchive& operator<<(T&& arg)
+        {
+            handle(std::forward<T>(arg));
+            return *this;
+        }
+
+    private:
+
+        /*! Forwards user archive and crps mapper with types. 
+            A failed serialization leaves the archive completed, so that ~CRPSOutputArchive 
+            does not save book-keeping for a partial traversal. 
+            @throws CRPSException If attempted serialization afterCRPSArchiveBase::complete called. 
+        */
+        template <class ... Types> inline
+        void handle(Types&& ... args)
+        {
+            if (completed) {
+                throw CRPSException("Attempted serialization after CRPSArchiveBase::complete called");
+            }
+
+            try {
+                if (concurrent_mapper) {
+                    handleConcurrently(args...);
+                }
+                else {
+                    writeUserArchives(args...);
+                    trackPointers(std::forward<Types>(args)...);
+                }
+            }
+            catch (...) {
+                completed = true;
+                throw;
+            }
+        }
+
+        /*! Tracks types on a worker thread while writing them to the user archives, and joins the worker. 
+            A failure of the user archives is rethrown in preference to a failure of the crps mapper. 
+        */
+        template <class ... Types> inline
+        void handleConcurrently(Types& ... args)
+        {
+            if (!mapper_worker) {
+                mapper_worker.reset(new detail::MapperWorker());
+            }
+            auto track = [&]() { trackPointers(args...); };
+            mapper_worker->start(&detail::run_task<decltype(track)>, &track);
+
+            std::exception_ptr failure{};
+            try {
+                writeUserArchives(args...);
+            }
+            catch (...) {
+                failure = std::current_exception();
+            }
+
+            if (failure)
+            {
+                try {
+                    mapper_worker->wait();
+                }
+                catch (...) {
+                }
+                std::rethrow_exception(failure);
+            }
+            mapper_worker->wait();
+        }
+
+        //! Forwards types to the user archives.
+        template <class ... Types> inline
+        void writeUserArchives(Types& ... args)
+        {
+            CRPS_TRACE_SCOPE("user_archive");
+            tee(detail::make_index_sequence<sizeof...(Archives)>{}, args...);
+            archive(args...);
+        }
+
+        //! Forwards types to the crps mapper.
+        template <class ... Types> inline
+        void trackPointers(Types&& ... args)
+        {
+            CRPS_TRACE_SCOPE("mapper");
+            pointer_mapper(std::forward<Types>(args)...);
+            CRPS_TRACE_STATS(pointer_mapper.stats());
+        }
+
+        //! Serializes deferments, and starts generating pointer book-keeping with the launch policy.
+        void beginComplete(std::launch policy)
+        {
+            completed = true;
+            serializeDeferments();
+
+            pending_table = std::async(policy, &CRPSOutputMapper::pointerTable, &pointer_mapper).share();
+        }
+
+        //! Generates the pointer book-keeping that complete_step has not generated yet
+        std::vector<std::uint32_t> resolveRemainingPointers()
+        {
+            pointer_mapper.resolvePointers(sliced_table, std::chrono::steady_clock::time_point::max());
+            return std::move(sliced_table);
+        }
+
+        /*! Serializes the deferments of the user archives and crps mapper. The crps mapper 
+            runs its own deferments, so objects of cereal::defer are tracked, and pointers 
+            to them are resolved, in the order the user archives save them. 
+        */
+        void serializeDeferments()
+        {
+            CRPS_TRACE_SCOPE("deferments");
+            archive.serializeDeferments();
+            teeDeferments(detail::make_index_sequence<sizeof...(Archives)>{});
+            pointer_mapper.serializeDeferments();
+            CRPS_TRACE_STATS(pointer_mapper.stats());
+        }
+
+        //! Saves the pointer book-keeping to the user archives, once generated.
+        void finishComplete()
+        {
+            if (!pending_table.valid()) {
+                return;
+            }
+            std::shared_future<std::vector<std::uint32_t>> table = std::move(pending_table);
+
+            std::vector<std::uint32_t> const& raw_to_obj = table.get();
+            CRPS_TRACE_SCOPE("save_pointer_table");
+            CRPS_TRACE_COUNTS(pointer_mapper.stats().objects, raw_to_obj.size());
+            savePointerTable(archive, raw_to_obj);
+            teePointerTable(detail::make_index_sequence<sizeof...(Archives)>{}, raw_to_obj);
+        }
+
+        //! Saves pointer book-keeping to a user archive, packed if compact pointers are set.
+        template <class UserArchive> inline
+        void savePointerTable(UserArchive& ar, std::vector<std::uint32_t> const& raw_to_obj)
+        {
+            if (compact_pointers) {
+                detail::save_packed_table(ar, raw_to_obj);
+            }
+            else {
+                ar(raw_to_obj);
+            }
+        }
+
+        //! Saves pointer book-keeping to each additional user archive.
+        template <std::size_t ... I> inline
+        void teePointerTable(detail::index_sequence<I...>, std::vector<std::uint32_t> const& raw_to_obj)
+        {
+            (void)detail::swallow{ 0, (savePointerTable(std::get<I>(tee_archives), raw_to_obj), 0)... };
+        }
+
+        //! Forwards types to each additional user archive.
+        template <std::size_t ... I, class ... Types> inline
+        void tee(detail::index_sequence<I...>, Types& ... args)
+        {
+            (void)detail::swallow{ 0, (std::get<I>(tee_archives)(args...), 0)... };
+        }
+
+        //! Serializes the deferments of each additional user archive.
+        template <std::size_t ... I> inline
+        void teeDeferments(detail::index_sequence<I...>)
+        {
+            (void)detail::swallow{ 0, (std::get<I>(tee_archives).serializeDeferments(), 0)... };
+        }
+
+    private:
+        Archive& archive; //!< User provided serialization archive
+
+        std::tuple<Archives&...> tee_archives; //!< Additional user provided serialization archives
+
+        CRPSOutputMapper pointer_mapper; //!< type is CRPSOutputMapper if Archive::is_saving, otherwise CRPSInputMapper
+
+        std::shared_future<std::vector<std::uint32_t>> pending_table{}; //!< Pointer book-keeping that is not yet saved to the user archives
+
+        std::vector<std::uint32_t> sliced_table{}; //!< Pointer book-keeping generated so far by complete_step
+
+        bool slicing{ false }; //!< True if complete_step has not finished generating pointer book-keeping
+
+        bool compact_pointers{ false }; //!< True if pointer book-keeping is packed into one binary value for text archives
+
+        bool concurrent_mapper{ false }; //!< True if the crps mapper tracks each serialization on a worker thread
+
+        std::unique_ptr<detail::MapperWorker> mapper_worker{}; //!< Thread of the concurrent mapper, once started
 
         bool completed{ false }; //!< True if CRPSOutputMapper or CRPSInputMapper complete method has been called
     };
-
+    
     // ###################################################################### 
-    //! Performs pointer book-keeping when saving classes to an OutputArchive. 
-    /*! This class is used by CRPSOutputArchive to associate the memory address
-        of each object or pointer it encounters with a graph traversal id. 
-        CRPSInputArchive then provides this class with the user's archive to 
-        save book-keeping (in the form of a pointer-id to object-id map) created 
-        by the graph traversal data. 
+    //! A wrapper that enables serializing raw pointers for output archives.
+    /*! This class enables an archive to be used to serialize raw pointers 
+        that point to types co-serialized by the graph traversal. It provides 
+        an archive interface that wraps the interface of the provided user archive, 
+        to intercept objects and store their memory addresses. 
 
-        @internal */
-    class CRPSOutputMapper : public cereal::OutputArchive<CRPSOutputMapper, cereal::AllowEmptyClassElision>, public detail::CRPSMapperCore
+        Upon ~CRPSInputArchive or CRPSInputArchive::complete, 
+        a vector used for mapping pointer indexes to object traversal indexes 
+        is loaded from the user provided archive and is used to restore the 
+        association of pointers relative to object traversal indexes. An exception 
+        is thrown if serialization is attempted after CRPSInputArchive::complete. 
+
+        Tracking addresses of BinaryData is not currently supported.
+
+        @endcode */
+
+    template<class Archive>
+    class CRPSInputArchive
     {
     public:
 
-        //! Empty object_address_to_object_id map associates an address of nullptr to an object-id of 0
-        CRPSOutputMapper() :
-            OutputArchive<CRPSOutputMapper, cereal::AllowEmptyClassElision>(this)
+        /*! @param archive The archive provided by the user, its interface is wrapped for object tracking. */
+        CRPSInputArchive(Archive& archive) : archive(archive)
+        { 
+            static_assert(Archive::is_loading::value, "CRPSInputArchive<Archive> cannot be used with an output archive.");
+        }
+
+        /*! Complete defered action if not completed. */
+        ~CRPSInputArchive()
         {
-            obj_ptr_to_id[nullptr] = map_insert_count++;
+            complete();
         }
 
-        /*! Creates pointer_id_to_object_id map from pointers/objects tracked from traversal. 
-            Saves map to output_archive. 
-   
-            @param output_archive A copy of the users's output_archive reference stored in the CRPSInputArchive 
-            */
-        template <class Archive>
-        void complete(Archive& output_archive)
+        /*! For OutputArchive: generates pointer book-keeping and saves book-keeping to output_archive,
+            For InputArchive: loads book-keeping from input_archive and does defered pointer initialization.
+
+            @throws CRPSException If pointer-booking serialization or defered pointer initialization fails.
+        */
+        void complete()
         {
-            std::vector<std::uint32_t> raw_to_obj{};
+            if (!completed) {
+                beginComplete(std::launch::deferred);
+            }
+            finishComplete();
+        }
 
-            for (const auto rpv : raw_ptr_values) 
-            {
-                if (obj_ptr_to_id.count(rpv) == 0) 
-                {
-                    std::ostringstream address{};
-                    address << rpv;
-                    throw CRPSException("Memory address " + address.str() + " not found in serialization traversal");
-                }
-                raw_to_obj.push_back(obj_ptr_to_id[rpv]);
+        /*! Loads pointer book-keeping from the user archive on the calling thread, then performs 
+            defered pointer initialization on a worker thread. The user archive may be used for 
+            further reads while the pointers are initialized, but the loaded objects must not be 
+            accessed until the returned future is waited on, or until complete is called. 
+
+            The returned future must not outlive the archive. 
+
+            @throws CRPSException If pointer-booking serialization fails, or from the returned future, 
+                                  if defered pointer initialization fails. 
+        */
+        std::future<void> complete_async()
+        {
+            if (!completed) {
+                beginComplete(std::launch::async);
             }
+            return std::async(std::launch::deferred, &CRPSInputArchive::finishComplete, this);
+        }
 
-            output_archive(raw_to_obj);
+        /*! Resolves external object-ids saved by CRPSOutputArchive::setExternalObjects 
+            against the objects of an external graph. 
+
+            @param objects The ExternalObjects of the loaded external graph, which must outlive the archive 
+            */
+        void setExternalObjects(ExternalObjects const& objects)
+        {
+            pointer_mapper.setExternalObjects(objects);
         }
 
-        //! Associate the object memory address with next object id
-        template <class T> inline
-        void trackAddress(T const& t)
+        //! Loads pointer book-keeping saved by a CRPSOutputArchive with compact pointers set
+        void setCompactPointers(bool compact)
         {
-            obj_ptr_to_id[std::addressof(t)] = map_insert_count++;
+            compact_pointers = compact;
         }
 
-        //! Associate the pointer value with next pointer id, and track it as an object
-        template <class T> inline
-        void trackPointer(T* const& p)
+        /*! Throws a CRPSException from the serialization that makes the pointer book-keeping 
+            exceed limits, before the book-keeping grows any further. Independently of the limits, 
+            a loaded pointer book-keeping whose size does not match the traversal is rejected 
+            before it is allocated. 
+            */
+        void setLimits(CRPSLimits const& limits)
         {
-            raw_ptr_values.push_back(p);
-            trackAddress(p);
+            pointer_mapper.setLimits(limits);
         }
 
-    private:
-        std::unordered_map<const void*, std::uint32_t> obj_ptr_to_id{}; //!< Associates object memory address with object-id
+        /*! Keeps a compact pointer table after complete, so that pointers may be repatched 
+            by relocate. It holds the address and target index of each loaded pointer and the 
+            address of each distinct target. By default nothing is retained by complete. */
+        void setRetainTables(bool retain)
+        {
+            pointer_mapper.setRetainTables(retain);
+        }
 
-        std::uint32_t map_insert_count{}; //!< Next available object-id
+        /*! Reloads into an existing, identically shaped graph. Pointers are only written 
+            where their target changed, so the pointers of the graph must be initialized. 
 
-        std::vector<const void*> raw_ptr_values{}; //!< Associates pointer value to pointer-id
+            Members and std::vector elements are already loaded in place by cereal, 
+            when the size of the std::vector is unchanged. Smart pointers are loaded 
+            in place if serialized through crps::in_place. The memory addresses of 
+            such a graph remain stable, as do external pointers into the graph. 
 
-        bool completed{ false }; //!< True if pointer book-keeping is saved to user archive
-    };
+            The option applies to pointers as they are loaded, so it must be set before 
+            the first serialization. 
 
-    // ######################################################################  
-    //! Performs pointer book-keeping when loading classes from an InputArchive. 
-    /*! This class is used by CRPSInputArchive to associate the memory address
-        of each object or pointer it encounters with a graph traversal id. 
-        CRPSInputArchive then provides this class with the user's archive to 
-        load book-keeping (in the form of a pointer-id to object-id map) to 
-        initialize the pointers. 
+            @code{cpp}
+            crps::CRPSInputArchive<cereal::BinaryInputArchive> crps_iarchive(iarchive);
+            crps_iarchive.setInPlace(true);
+            crps_iarchive(config);
+            @endcode
 
-        @internal */
-    class CRPSInputMapper : public cereal::OutputArchive<CRPSInputMapper, cereal::AllowEmptyClassElision>, public detail::CRPSMapperCore
-    {
-    public:
+            @throws CRPSException If a pointer was already loaded. 
+            */
+        void setInPlace(bool reload)
+        {
+            pointer_mapper.setInPlace(reload);
+        }
 
-        //! Empty object_id_to_object_address map associates an object-id of 0 to a memory address of nullptr 
-        CRPSInputMapper() :
-            OutputArchive<CRPSInputMapper, cereal::AllowEmptyClassElision>(this)
+        /*! Moves the objects of placed_ptr serialized through crps::placed into arena when 
+            complete, so that objects used together are stored together instead of being 
+            scattered over the heap. Objects are moved in order, which by default is 
+            breadth-first from each object not owned by another placed object, following 
+            ownership and pointers. Tracked pointers into and out of moved objects are 
+            rewritten. 
+
+            Objects are moved with their move constructor, so pointers into a moved object 
+            that are not tracked by crps, such as references held by user code, are not 
+            updated. Placed objects remain placed when the graph is reloaded in place. 
+
+            @param arena The arena objects are moved into, which must outlive the placed objects 
+            @param order The order objects are moved into the arena 
+            */
+        void setPlacement(PlacementArena& arena, PlacementOrder order = PlacementOrder::BreadthFirst)
         {
-            obj_ptrs.push_back(nullptr);
+            pointer_mapper.setPlacement(&arena, order);
         }
 
-        /*! Loads pointer_id_to_object_id map from input_archive.
-            Performs defered pointer initializations (with pointers/objects tracked in traversal) using pointer_id_to_object_id map. 
+        /*! Repatches pointers after loaded objects are moved from one memory region to another, 
+            for example by std::vector::shrink_to_fit or by moving objects into an arena. 
 
-            @param input_archive A copy of the users's input_archive reference stored in the CRPSInputArchive 
+            @code{cpp}
+            const void* old_base = vertices.data();
+            std::size_t bytes = vertices.size() * sizeof(Vertex);
+            vertices.shrink_to_fit();
+            crps_iarchive.relocate(old_base, vertices.data(), bytes);
+            @endcode
+
+            @throws CRPSException If called before complete, or if tables were not retained. 
             */
-        template <class Archive>
-        void complete(Archive& input_archive)
+        void relocate(const void* old_base, void* new_base, std::size_t bytes)
         {
-            std::vector<std::uint32_t> raw_to_obj{};
-            input_archive(raw_to_obj);
-            
-            if (raw_to_obj.size() != raw_ptrs.size()) {
-                throw CRPSException("Size of raw_ptr_to_obj_id map loaded from input archive does not match size of map generated from traversal");
+            if (!completed) {
+                throw CRPSException("Attempted relocation before CRPSInputArchive::complete called");
             }
+            finishComplete();
+            pointer_mapper.relocate(old_base, new_base, bytes);
+        }
 
-            for (int i = 0; i < raw_ptrs.size(); i++)
-            {
-                if (raw_to_obj[i] >= obj_ptrs.size())
-                {
-                    std::ostringstream address{};
-                    address << raw_ptrs[i];
-                    throw CRPSException("Pointer at memory address " + address.str() + " has object index exceeding object traversal count");
-                }
-                deferedPtrLoads[i](raw_ptrs[i], obj_ptrs[raw_to_obj[i]]);
-            }
+        //! Forwards types to user archive and crps mapper. 
+        template <class ... Types> inline
+        CRPSInputArchive& operator()(Types&& ... args)
+        {
+            handle(std::forward<Types>(args)...);
+            return *this;
         }
 
-        //! Associate the object id to the object memory address.
+        //! This is a boost compatability layer.
         template <class T> inline
-        void trackAddress(T& t)
+        CRPSInputArchive& operator&(T&& arg)
         {
-            obj_ptrs.push_back(std::addressof(t));
+            handle(std::forward<T>(arg));
+            return *this;
         }
 
-        //! Associate the pointer id to the pointer's memory address, and track it as an object
+        //! This is a boost compatability layer.
         template <class T> inline
-        void trackPointer(T*& p)
+        CRPSInputArchive& operator>>(T&& arg)
         {
-            raw_ptrs.push_back(std::addressof(p));
-            std::function<void(void*, void*)> deferment([](void* raw, void* obj_address) { *static_cast<T**>(raw) = static_cast<T*>(obj_address); });
-            deferedPtrLoads.emplace_back(std::move(deferment));
+            handle(std::forward<T>(arg));
+            return *this;
+        }
 
-            trackAddress(p);
+    private:
+
+        /*! Forwards user archive and crps mapper with types.
+            A failed serialization leaves the archive completed, so that ~CRPSInputArchive 
+            does not load book-keeping for a partial traversal. 
+            @throws CRPSException If attempted serialization afterCRPSArchiveBase::complete called.
+        */
+        template <class ... Types> inline
+        void handle(Types&& ... args)
+        {
+            if (completed) {
+                throw CRPSException("Attempted serialization after CRPSArchiveBase::complete called");
+            }
+
+            try {
+                {
+                    CRPS_TRACE_SCOPE("user_archive");
+                    archive(std::forward<Types>(args)...);
+                }
+                {
+                    CRPS_TRACE_SCOPE("mapper");
+                    pointer_mapper(std::forward<Types>(args)...);
+                    CRPS_TRACE_COUNTS(pointer_mapper.objectCount(), pointer_mapper.pointerCount());
+                }
+            }
+            catch (...) {
+                completed = true;
+                throw;
+            }
+        }
+
+        //! Serializes deferments and loads pointer book-keeping, and starts defered pointer initialization with the launch policy.
+        void beginComplete(std::launch policy)
+        {
+            completed = true;
+
+            {
+                CRPS_TRACE_SCOPE("deferments");
+                archive.serializeDeferments();
+                // Tracks the objects of cereal::defer in the order the user archive loads them
+                pointer_mapper.serializeDeferments();
+                CRPS_TRACE_COUNTS(pointer_mapper.objectCount(), pointer_mapper.pointerCount());
+            }
+
+            std::vector<std::uint32_t> raw_to_obj{};
+            {
+                CRPS_TRACE_SCOPE("load_pointer_table");
+                raw_to_obj = compact_pointers ? detail::load_packed_table(archive, pointer_mapper.pointerCount()) : pointer_mapper.loadPointerTable(archive);
+                CRPS_TRACE_COUNTS(pointer_mapper.objectCount(), raw_to_obj.size());
+            }
+            pending_pointers = std::async(policy, &CRPSInputMapper::completePointers, &pointer_mapper, std::move(raw_to_obj)).share();
+        }
+
+        //! Waits for defered pointer initialization.
+        void finishComplete()
+        {
+            if (!pending_pointers.valid()) {
+                return;
+            }
+            std::shared_future<void> pointers = std::move(pending_pointers);
+            pointers.get();
         }
 
     private:
-        std::vector<void*> obj_ptrs{}; //!< Associates object-id with an object's memory address
+        Archive& archive; //!< User provided serialization archive
 
-        std::vector<void*> raw_ptrs{}; //!< Associates pointer-id with a pointer's memory address
-        std::vector<std::function<void(void*, void*)>> deferedPtrLoads{}; //!< Type-specific pointer initialization functions
+        CRPSInputMapper pointer_mapper; //!< type is CRPSOutputMapper if Archive::is_saving, otherwise CRPSInputMapper
 
-        bool completed{ false }; //!< True if defered pointer initialization is completed
+        std::shared_future<void> pending_pointers{}; //!< Defered pointer initialization that is not yet waited on
+
+        bool compact_pointers{ false }; //!< True if pointer book-keeping is packed into one binary value for text archives
+
+        bool completed{ false }; //!< True if CRPSOutputMapper or CRPSInputMapper complete method has been called
     };
 
     //! Track memory address of POD types for defered saving of pointer associations
@@ -550,6 +3774,92 @@ namespace crps
         ar.trackAddress(t.ptr.ref);
     }
 
+    //! Track the elements of a blit array for defered saving of pointer associations
+    template <class T, class A> inline
+    void CEREAL_SAVE_FUNCTION_NAME(CRPSOutputMapper& ar, PtrWrapper<BlitArray<T, A>&> const& t)
+    {
+        ar.trackRange(t.ptr.vector.data(), sizeof(T), t.ptr.vector.size());
+    }
+
+    //! Track the elements of a blit array for defered loading of pointer associations
+    template <class T, class A> inline
+    void CEREAL_SAVE_FUNCTION_NAME(CRPSInputMapper& ar, PtrWrapper<BlitArray<T, A>&> const& t)
+    {
+        ar.trackRange(t.ptr.vector.data(), sizeof(T), t.ptr.vector.size());
+    }
+
+    //! Traverse the object of a placed_ptr for defered saving of pointer associations
+    template <class T> inline
+    void CEREAL_SAVE_FUNCTION_NAME(CRPSOutputMapper& ar, PtrWrapper<PlacedPointer<T>&> const& t)
+    {
+        ar(static_cast<placed_ptr<T> const&>(t.ptr.ptr));
+    }
+
+    //! Register the object of a placed_ptr for placement, and traverse it for defered loading of pointer associations
+    template <class T> inline
+    void CEREAL_SAVE_FUNCTION_NAME(CRPSInputMapper& ar, PtrWrapper<PlacedPointer<T>&> const& t)
+    {
+        ar.trackPlacement(t.ptr.ptr);
+        ar(static_cast<placed_ptr<T> const&>(t.ptr.ptr));
+    }
+
+    //! Traverse the object of a placed_ptr for external object-ids
+    template <class T> inline
+    void CEREAL_SAVE_FUNCTION_NAME(ExternalObjects& ar, PtrWrapper<PlacedPointer<T>&> const& t)
+    {
+        ar(static_cast<placed_ptr<T> const&>(t.ptr.ptr));
+    }
+
+    //! Track memory address of POD types for external object-ids
+    template <class T> inline
+    typename std::enable_if<std::is_arithmetic<T>::value, void>::type
+    CEREAL_SAVE_FUNCTION_NAME(ExternalObjects& ar, T const& t)
+    {
+        ar.trackAddress(t);
+    }
+
+    //! Track memory address of class types for external object-ids
+    template<class T> inline
+    void CEREAL_SAVE_FUNCTION_NAME(ExternalObjects& ar, PtrWrapper<ThisPointer<T>&> const& t)
+    {
+        ar.trackAddress(t.ptr.ref);
+    }
+
+    //! Track address of types in NameValuePair wrapper for external object-ids
+    template <class T> inline
+    void CEREAL_SERIALIZE_FUNCTION_NAME(ExternalObjects& ar, cereal::NameValuePair<T>& t)
+    {
+        ar(t.value);
+    }
+
+    //! Track address of sizes in SizeTag wrapper for external object-ids
+    template <class T> inline
+    void CEREAL_SERIALIZE_FUNCTION_NAME(ExternalObjects& ar, cereal::SizeTag<T>& t)
+    {
+        ar(t.size);
+    }
+
+    //! Track pointer's memory address for external object-ids
+    template <class T> inline
+    void CEREAL_SAVE_FUNCTION_NAME(ExternalObjects& ar, PtrWrapper<T*&> const& rpw)
+    {
+        ar.trackPointer(rpw.ptr);
+    }
+
+    //! Track the elements of a blit array for external object-ids
+    template <class T, class A> inline
+    void CEREAL_SAVE_FUNCTION_NAME(ExternalObjects& ar, PtrWrapper<BlitArray<T, A>&> const& t)
+    {
+        ar.trackRange(t.ptr.vector.data(), sizeof(T), t.ptr.vector.size());
+    }
+
+    //! Do-nothing specialization for binary data
+    template <class T> inline
+    void CEREAL_SAVE_FUNCTION_NAME(ExternalObjects&, cereal::BinaryData<T> const&)
+    {
+    
+    }
+
     /*! Track address of types in NameValuePair wrapper.
         t.value may be a wrapper type that must be unpacked, so  &(t.value) is not directly taken 
         */
@@ -600,10 +3910,12 @@ namespace crps
     }
 
 }
+}
 
 
 CEREAL_REGISTER_ARCHIVE(crps::CRPSOutputMapper)
 CEREAL_REGISTER_ARCHIVE(crps::CRPSInputMapper)
+CEREAL_REGISTER_ARCHIVE(crps::ExternalObjects)
 
 CEREAL_SETUP_ARCHIVE_TRAITS(crps::CRPSInputMapper, crps::CRPSOutputMapper)
 
@@ -0,0 +1,165 @@
+#ifndef CRPS_FRAGMENT_HPP_
+#define CRPS_FRAGMENT_HPP_
+
+#include "crps/crps.hpp"
+#include "cereal/archives/binary.hpp"
+#include <sstream>
+
+namespace crps
+{
+inline namespace CRPS_TRACE_NAMESPACE
+{
+    template <class Archive>
+    class FragmentCache;
+
+    namespace detail
+    {
+        //! A subtree saved by FragmentCache
+        struct Fragment
+        {
+            std::uint64_t version;                              //!< Version of the object when the fragment was saved
+            std::string bytes;                                  //!< Output of the user archive for the object
+            std::shared_ptr<const CRPSOutputMapper> mapper;     //!< Objects and pointers tracked for the object
+        };
+    }
+
+    // ######################################################################
+    //! An archivable wrapper for an object saved through a FragmentCache.
+    /*! Saves the cached output of the user archive in place of the object, and
+        splices the cached pointer book-keeping of the object into CRPSOutputMapper.
+        The output is identical to saving the object itself, so the object is
+        loaded as usual by CRPSInputArchive.
+
+        @internal */
+    template <class Archive>
+    class CachedFragment
+    {
+    public:
+
+        CachedFragment(std::shared_ptr<const detail::Fragment> fragment) : fragment(std::move(fragment)) {}
+
+        std::shared_ptr<const detail::Fragment> fragment;
+
+        //! Splice the cached book-keeping into CRPSOutputMapper
+        template<class MapperArchive> inline
+        typename std::enable_if<std::is_base_of<detail::CRPSMapperCore, MapperArchive>::value, void>::type
+        CEREAL_SERIALIZE_FUNCTION_NAME(MapperArchive& ar)
+        {
+            ar.spliceFragment(fragment->mapper);
+        }
+
+        //! Representation for the user archive.
+        template<class UserArchive> inline
+        typename std::enable_if<!std::is_base_of<detail::CRPSMapperCore, UserArchive>::value, void>::type
+        CEREAL_SERIALIZE_FUNCTION_NAME(UserArchive& ar)
+        {
+            static_assert(std::is_same<UserArchive, Archive>::value, "CachedFragment must be saved to the archive type of its FragmentCache");
+
+            ar(cereal::binary_data(fragment->bytes.data(), fragment->bytes.size()));
+        }
+    };
+
+    // ######################################################################
+    //! Caches the output of unchanged subobjects between CRPS saves.
+    /*! A FragmentCache stores the output of a cereal::BinaryOutputArchive for an object,
+        along with its pointer book-keeping, keyed by the address and a user provided
+        version of the object. Saving the fragment of an unchanged object copies the
+        cached output and splices the cached book-keeping, without traversing the object.
+        Object-ids of the fragment are relative to the fragment, and are shifted to
+        their position in the save when the pointer book-keeping is generated.
+
+        The user must change the version whenever the object, or an object reachable
+        from it, is modified or moved. A fragment cannot contain shared pointers or
+        polymorphic pointers, as these are tracked per archive by cereal, and should
+        not contain deferred data, which is saved at the end of the fragment.
+
+        Archive must be cereal::BinaryOutputArchive, whose output of an object can be
+        spliced as raw bytes. Other archives write a preamble per archive, such as the
+        endianness of cereal::PortableBinaryOutputArchive, or text that depends on the
+        enclosing nodes, such as cereal::JSONOutputArchive.
+
+        Example:
+        @code{cpp}
+        crps::FragmentCache<cereal::BinaryOutputArchive> cache;
+        ...
+        crps_oarchive(scene, cache.fragment(mesh, mesh_version), edges);
+        @endcode
+
+        The output is loaded with crps_iarchive(scene, mesh, edges).
+
+        @ingroup Utility */
+    template <class Archive>
+    class FragmentCache
+    {
+        static_assert(std::is_same<Archive, cereal::BinaryOutputArchive>::value, "FragmentCache<Archive> only supports cereal::BinaryOutputArchive");
+
+    public:
+
+        /*! Retrieves the fragment of an object, saving it if the cached fragment is missing or out of date.
+
+            @param object The object, which must keep its address while its version is unchanged
+            @param version The version of the object
+            @throws CRPSException If the object contains shared pointers or polymorphic pointers.
+            */
+        template <class T>
+        CachedFragment<Archive> fragment(T const& object, std::uint64_t version)
+        {
+            auto& cached = fragments[std::addressof(object)];
+
+            if (!cached || cached->version != version) {
+                cached = save(object, version);
+            }
+            return { cached };
+        }
+
+        //! Removes the fragment of an object from the cache
+        template <class T>
+        void erase(T const& object)
+        {
+            fragments.erase(std::addressof(object));
+        }
+
+        //! Removes all fragments from the cache
+        void clear()
+        {
+            fragments.clear();
+        }
+
+        //! Number of cached fragments
+        std::size_t size() const
+        {
+            return fragments.size();
+        }
+
+    private:
+
+        //! Saves the output of the user archive and the pointer book-keeping of an object
+        template <class T>
+        static std::shared_ptr<const detail::Fragment> save(T const& object, std::uint64_t version)
+        {
+            std::shared_ptr<CRPSOutputMapper> mapper = std::make_shared<CRPSOutputMapper>();
+            (*mapper)(object);
+            mapper->serializeDeferments();
+            mapper->prepareSplicing();
+
+            if (mapper->archiveRegistrations() != 0) {
+                throw CRPSException("FragmentCache cannot save objects containing shared pointers or polymorphic pointers");
+            }
+
+            std::ostringstream stream{};
+            {
+                Archive archive(stream);
+                archive(object);
+                archive.serializeDeferments();
+            }
+
+            return std::make_shared<detail::Fragment>(detail::Fragment{ version, stream.str(), std::move(mapper) });
+        }
+
+    private:
+        std::unordered_map<const void*, std::shared_ptr<const detail::Fragment>> fragments{}; //!< Associates object memory address with its fragment
+    };
+}
+}
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef CRPS_HASH_HPP_
+#define CRPS_HASH_HPP_
+
+#include "crps/crps.hpp"
+#include <cstring>
+
+namespace crps
+{
+inline namespace CRPS_TRACE_NAMESPACE
+{
+    // ######################################################################
+    //! An output archive that computes a digest instead of producing output.
+    /*! The digest covers the same values that cereal::BinaryOutputArchive would
+        write. When used through CRPSOutputArchive, the pointer-id to object-id
+        map is saved into the digest as well, so pointer topology is hashed as
+        traversal ids rather than memory addresses. Equal graphs therefore hash
+        equal across processes running on the same platform.
+
+        The digest is not cryptographic, it is intended for change detection
+        and deduplication of snapshots.
+
+        @ingroup Utility */
+    class HashOutputArchive : public cereal::OutputArchive<HashOutputArchive, cereal::AllowEmptyClassElision>
+    {
+    public:
+
+        HashOutputArchive() :
+            OutputArchive<HashOutputArchive, cereal::AllowEmptyClassElision>(this)
+        {
+
+        }
+
+        //! Mix a block of bytes into the digest
+        void saveBinary(const void* data, std::size_t size)
+        {
+            const unsigned char* bytes = static_cast<const unsigned char*>(data);
+            std::uint64_t word;
+
+            for (; size >= sizeof(word); size -= sizeof(word), bytes += sizeof(word))
+            {
+                std::memcpy(&word, bytes, sizeof(word));
+                mix(word);
+            }
+
+            word = size;
+            if (size != 0) {
+                std::memcpy(&word, bytes, size);
+                word ^= static_cast<std::uint64_t>(size) << 56;
+            }
+            mix(word);
+        }
+
+        //! The digest of all values saved so far
+        std::uint64_t digest() const
+        {
+            std::uint64_t h = state;
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ULL;
+            h ^= h >> 33;
+            return h;
+        }
+
+    private:
+
+        void mix(std::uint64_t word)
+        {
+            state = (state ^ word) * 0x9e3779b97f4a7c15ULL;
+            state ^= state >> 32;
+        }
+
+    private:
+        std::uint64_t state{ 0x84222325cbf29ce4ULL }; //!< Running digest state
+    };
+
+    //! Hash arithmetic types by their object representation
+    template <class T> inline
+    typename std::enable_if<std::is_arithmetic<T>::value, void>::type
+    CEREAL_SAVE_FUNCTION_NAME(HashOutputArchive& ar, T const& t)
+    {
+        ar.saveBinary(std::addressof(t), sizeof(t));
+    }
+
+    //! Unwrap NameValuePair, names are not hashed
+    template <class T> inline
+    void CEREAL_SERIALIZE_FUNCTION_NAME(HashOutputArchive& ar, cereal::NameValuePair<T>& t)
+    {
+        ar(t.value);
+    }
+
+    //! Hash the size of SizeTag
+    template <class T> inline
+    void CEREAL_SERIALIZE_FUNCTION_NAME(HashOutputArchive& ar, cereal::SizeTag<T>& t)
+    {
+        ar(t.size);
+    }
+
+    //! Hash binary data
+    template <class T> inline
+    void CEREAL_SAVE_FUNCTION_NAME(HashOutputArchive& ar, cereal::BinaryData<T> const& bd)
+    {
+        ar.saveBinary(bd.data, static_cast<std::size_t>(bd.size));
+    }
+
+    //! Computes a digest over the values and pointer topology of an object graph
+    /*! Equivalent to saving args through a CRPSOutputArchive<HashOutputArchive>.
+
+        Example:
+        @code{cpp}
+        std::uint64_t digest = crps::hash(vertices, edges);
+        if (digest != last_checkpoint_digest) {
+            // write checkpoint
+        }
+        @endcode
+
+        @throws CRPSException If a pointer does not point to an object visited by the traversal.
+        @relates HashOutputArchive
+        @ingroup Utility
+        */
+    template <class ... Types> inline
+    std::uint64_t hash(Types&& ... args)
+    {
+        HashOutputArchive hash_archive{};
+        {
+            CRPSOutputArchive<HashOutputArchive> crps_archive(hash_archive);
+            crps_archive(std::forward<Types>(args)...);
+            crps_archive.complete();
+        }
+        return hash_archive.digest();
+    }
+}
+}
+
+CEREAL_REGISTER_ARCHIVE(crps::HashOutputArchive)
+
+#endif
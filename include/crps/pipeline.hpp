@@ -0,0 +1,342 @@
+#ifndef CRPS_PIPELINE_HPP_
+#define CRPS_PIPELINE_HPP_
+
+#include "crps/crps.hpp"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+namespace crps
+{
+inline namespace CRPS_TRACE_NAMESPACE
+{
+    // ######################################################################
+    //! A stream buffer that hands fixed-size buffers of output to a writer thread.
+    /*! Output is collected in one of buffer_count buffers of buffer_size bytes.
+        A full buffer is handed to a writer thread, which writes it to the sink
+        while the next buffer is filled, so encoding and blocking writes overlap.
+        When every buffer is waiting to be written, the writing thread waits for
+        the writer thread to return one, which bounds the memory of the pipeline.
+
+        The last buffer is handed off by close, or by ~PipelineBuffer, which wait
+        until every buffer is written. The sink must not be used by other threads
+        until then. A failed write of the sink fails every later write to the
+        buffer, so an archive writing to it throws, and close throws.
+
+        @code{cpp}
+        std::ofstream os("out.cereal", std::ios::binary);
+        crps::PipelineBuffer buffer(os);
+        std::ostream pipelined(&buffer);
+        save(pipelined);
+        buffer.close();
+        @endcode
+
+        @ingroup Utility */
+    class PipelineBuffer : public std::streambuf
+    {
+    public:
+
+        /*! @param sink The stream written by the writer thread, which must outlive the buffer
+            @param buffer_size Size in bytes of each buffer
+            @param buffer_count Number of buffers, at least 2 */
+        explicit PipelineBuffer(std::ostream& sink, std::size_t buffer_size = 1 << 20, std::size_t buffer_count = 2) :
+            sink(sink), buffers(buffer_count < 2 ? 2 : buffer_count)
+        {
+            for (std::vector<char>& buffer : buffers) {
+                buffer.resize(buffer_size == 0 ? 1 : buffer_size);
+                free_buffers.push_back(&buffer);
+            }
+            writer = std::thread(&PipelineBuffer::writeBuffers, this);
+            fill(takeFreeBuffer());
+        }
+
+        /*! Hands off the last buffer and waits until every buffer is written. */
+        ~PipelineBuffer() override
+        {
+            finish();
+        }
+
+        PipelineBuffer(PipelineBuffer const&) = delete;
+        PipelineBuffer& operator=(PipelineBuffer const&) = delete;
+
+        /*! Hands off the last buffer, waits until every buffer is written and flushes the sink.
+            The buffer must not be written to afterwards.
+
+            @throws CRPSException If a write to the sink failed.
+            */
+        void close()
+        {
+            finish();
+            if (failed) {
+                throw CRPSException("Failed to write pipelined output to the sink stream");
+            }
+        }
+
+    protected:
+
+        //! Hands off the full buffer and continues in a free buffer, waiting for one if none is free
+        int_type overflow(int_type ch) override
+        {
+            if (closed || failed) {
+                return traits_type::eof();
+            }
+            handOff(pptr() - pbase());
+            fill(takeFreeBuffer());
+
+            if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+                *pptr() = traits_type::to_char_type(ch);
+                pbump(1);
+            }
+            return failed ? traits_type::eof() : traits_type::not_eof(ch);
+        }
+
+        //! Hands off the buffer written so far without waiting for it to be written
+        int sync() override
+        {
+            if (closed || failed) {
+                return failed ? -1 : 0;
+            }
+            if (pptr() != pbase()) {
+                handOff(pptr() - pbase());
+                fill(takeFreeBuffer());
+            }
+            return 0;
+        }
+
+    private:
+
+        //! Starts filling buffer
+        void fill(std::vector<char>* buffer)
+        {
+            current = buffer;
+            setp(buffer->data(), buffer->data() + buffer->size());
+        }
+
+        //! Queues the first size bytes of the current buffer for the writer thread
+        void handOff(std::ptrdiff_t size)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                full_buffers.push_back(FullBuffer{ current, static_cast<std::size_t>(size) });
+            }
+            current = nullptr;
+            setp(nullptr, nullptr);
+            buffer_written.notify_all();
+        }
+
+        //! Takes a free buffer, waiting for the writer thread while every buffer is full
+        std::vector<char>* takeFreeBuffer()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (free_buffers.empty())
+            {
+                CRPS_TRACE_SCOPE("pipeline_stall");
+                buffer_freed.wait(lock, [this]() { return !free_buffers.empty(); });
+            }
+            std::vector<char>* buffer = free_buffers.front();
+            free_buffers.pop_front();
+            return buffer;
+        }
+
+        //! Writes full buffers to the sink until the buffer is closed, run by the writer thread
+        void writeBuffers()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            for (;;)
+            {
+                buffer_written.wait(lock, [this]() { return !full_buffers.empty() || closing; });
+                if (full_buffers.empty()) {
+                    break;
+                }
+                const FullBuffer full = full_buffers.front();
+                full_buffers.pop_front();
+                lock.unlock();
+
+                if (!failed)
+                {
+                    CRPS_TRACE_SCOPE("pipeline_write");
+                    if (!sink.write(full.buffer->data(), static_cast<std::streamsize>(full.size))) {
+                        failed = true;
+                    }
+                }
+
+                lock.lock();
+                free_buffers.push_back(full.buffer);
+                buffer_freed.notify_all();
+            }
+            if (!failed && !sink.flush()) {
+                failed = true;
+            }
+        }
+
+        //! Hands off the last buffer and joins the writer thread
+        void finish()
+        {
+            if (closed) {
+                return;
+            }
+            closed = true;
+            if (current != nullptr) {
+                handOff(pptr() - pbase());
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                closing = true;
+            }
+            buffer_written.notify_all();
+            writer.join();
+        }
+
+    private:
+        //! A buffer waiting for the writer thread
+        struct FullBuffer
+        {
+            std::vector<char>* buffer;  //!< Buffer to be written
+            std::size_t size;           //!< Bytes of the buffer to be written
+        };
+
+        std::ostream& sink; //!< Stream written by the writer thread
+
+        std::vector<std::vector<char>> buffers; //!< Every buffer of the pipeline
+
+        std::deque<std::vector<char>*> free_buffers{}; //!< Buffers that may be filled, guarded by mutex
+
+        std::deque<FullBuffer> full_buffers{}; //!< Buffers waiting for the writer thread in output order, guarded by mutex
+
+        std::vector<char>* current{ nullptr }; //!< Buffer being filled, null once closed
+
+        std::mutex mutex{}; //!< Guards free_buffers, full_buffers and closing
+
+        std::condition_variable buffer_freed{}; //!< Signalled when a buffer is returned to free_buffers
+
+        std::condition_variable buffer_written{}; //!< Signalled when a buffer is handed off or closing is set
+
+        std::thread writer{}; //!< Thread writing full buffers to the sink
+
+        std::atomic<bool> failed{ false }; //!< True once a write to the sink failed
+
+        bool closing{ false }; //!< True once the last buffer is handed off, guarded by mutex
+
+        bool closed{ false }; //!< True once finish was called
+    };
+
+    // ######################################################################
+    //! Saves through a CRPSOutputArchive into a PipelineBuffer.
+    /*! The user archive of type Archive is created on a PipelineBuffer over the
+        sink, so the traversal encodes into fixed-size buffers while a writer
+        thread writes earlier buffers to the sink. complete saves the pointer
+        book-keeping, which is appended to the last buffer, then destroys the user
+        archive, so archives that write on destruction are closed, and hands off
+        the last buffer and waits for it to be written.
+
+        The output is identical to a save by CRPSOutputArchive<Archive> to the
+        sink, and loads with CRPSInputArchive.
+
+        @code{cpp}
+        std::ofstream os("out.cereal", std::ios::binary);
+        crps::CRPSPipelinedOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(os);
+        crps_oarchive(vertices, edges);
+        crps_oarchive.complete();
+        @endcode
+
+        @ingroup Utility */
+    template <class Archive>
+    class CRPSPipelinedOutputArchive
+    {
+    public:
+
+        /*! @param sink The stream the output is written to, which must outlive the archive
+            @param buffer_size Size in bytes of each buffer of the pipeline
+            @param buffer_count Number of buffers of the pipeline, at least 2 */
+        explicit CRPSPipelinedOutputArchive(std::ostream& sink, std::size_t buffer_size = 1 << 20, std::size_t buffer_count = 2) :
+            buffer(sink, buffer_size, buffer_count), stream(&buffer),
+            user_archive(new Archive(stream)), crps_archive(new CRPSOutputArchive<Archive>(*user_archive))
+        {
+        }
+
+        /*! Complete the save if not completed. A failed write to the sink is only reported by complete. */
+        ~CRPSPipelinedOutputArchive()
+        {
+            close();
+        }
+
+        /*! Saves the pointer book-keeping, closes the user archive and waits until the output is written.
+
+            @throws CRPSException If pointer-booking serialization or a write to the sink fails.
+            */
+        void complete()
+        {
+            if (crps_archive)
+            {
+                try {
+                    crps_archive->complete();
+                }
+                catch (...) {
+                    close();
+                    throw;
+                }
+            }
+            close();
+            buffer.close();
+        }
+
+        //! The wrapped CRPSOutputArchive, for its options, which throws once the save is completed
+        CRPSOutputArchive<Archive>& archive()
+        {
+            if (!crps_archive) {
+                throw CRPSException("Attempted serialization after CRPSPipelinedOutputArchive::complete called");
+            }
+            return *crps_archive;
+        }
+
+        //! Forwards types to the wrapped CRPSOutputArchive.
+        template <class ... Types> inline
+        CRPSPipelinedOutputArchive& operator()(Types&& ... args)
+        {
+            archive()(std::forward<Types>(args)...);
+            return *this;
+        }
+
+        //! This is a boost compatability layer.
+        template <class T> inline
+        CRPSPipelinedOutputArchive& operator&(T&& arg)
+        {
+            archive()(std::forward<T>(arg));
+            return *this;
+        }
+
+        //! This is a boost compatability layer.
+        template <class T> inline
+        CRPSPipelinedOutputArchive& operator<<(T&& arg)
+        {
+            archive()(std::forward<T>(arg));
+            return *this;
+        }
+
+    private:
+
+        //! Destroys the wrapped archives, which saves nothing further once crps_archive is completed
+        void close()
+        {
+            crps_archive.reset();
+            user_archive.reset();
+        }
+
+    private:
+        PipelineBuffer buffer; //!< Buffers written to the sink by a writer thread
+
+        std::ostream stream; //!< Stream over buffer, written by the user archive
+
+        std::unique_ptr<Archive> user_archive; //!< User archive writing to stream, until completed
+
+        std::unique_ptr<CRPSOutputArchive<Archive>> crps_archive; //!< Archive wrapping user_archive, until completed
+    };
+}
+}
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef CRPS_SIZE_HPP_
+#define CRPS_SIZE_HPP_
+
+#include "crps/crps.hpp"
+#include <ostream>
+#include <streambuf>
+
+namespace crps
+{
+inline namespace CRPS_TRACE_NAMESPACE
+{
+    namespace detail
+    {
+        //! A stream buffer that discards its output and counts its size in bytes
+        class CountingStreambuf : public std::streambuf
+        {
+        public:
+
+            //! Number of bytes written so far
+            std::uint64_t size() const
+            {
+                return count;
+            }
+
+        protected:
+
+            std::streamsize xsputn(const char_type*, std::streamsize n) override
+            {
+                count += static_cast<std::uint64_t>(n);
+                return n;
+            }
+
+            int_type overflow(int_type c) override
+            {
+                if (!traits_type::eq_int_type(c, traits_type::eof())) {
+                    ++count;
+                }
+                return traits_type::not_eof(c);
+            }
+
+        private:
+            std::uint64_t count{}; //!< Number of bytes written so far
+        };
+    }
+
+    // ######################################################################
+    //! An output stream that discards its output and counts its size in bytes.
+    /*! Constructing a user archive on a CountingStream performs a dry run of
+        the save, which measures the exact size of the output without storing it.
+        This may be used in place of crps::output_size for archives that take
+        additional constructor arguments.
+
+        @ingroup Utility */
+    class CountingStream : public std::ostream
+    {
+    public:
+
+        CountingStream() : std::ostream(nullptr)
+        {
+            rdbuf(&counting_buffer);
+        }
+
+        //! Number of bytes written so far
+        std::uint64_t size() const
+        {
+            return counting_buffer.size();
+        }
+
+    private:
+        detail::CountingStreambuf counting_buffer{}; //!< Discards and counts the output of the stream
+    };
+
+    //! Computes the exact size in bytes of a CRPSOutputArchive<Archive> save, without producing output
+    /*! The save is performed into a CountingStream, so the size includes the pointer-id
+        to object-id map, and anything written by the destructor of Archive. The result
+        may be used to preallocate a buffer or file extent before the real save.
+
+        Example:
+        @code{cpp}
+        std::uint64_t bytes = crps::output_size<cereal::BinaryOutputArchive>(vertices, edges);
+        std::string buffer;
+        buffer.reserve(bytes);
+        @endcode
+
+        @throws CRPSException If a pointer does not point to an object visited by the traversal.
+        @ingroup Utility
+        */
+    template <class Archive, class ... Types> inline
+    std::uint64_t output_size(Types&& ... args)
+    {
+        CountingStream stream{};
+        {
+            Archive archive(stream);
+            CRPSOutputArchive<Archive> crps_archive(archive);
+            crps_archive(std::forward<Types>(args)...);
+            crps_archive.complete();
+        }
+        return stream.size();
+    }
+}
+}
+
+#endif
@@ -0,0 +1,173 @@
+#ifndef CRPS_SLICED_HPP_
+#define CRPS_SLICED_HPP_
+
+#include "crps/crps.hpp"
+#include <chrono>
+#include <deque>
+#include <functional>
+
+namespace crps
+{
+inline namespace CRPS_TRACE_NAMESPACE
+{
+    namespace detail
+    {
+        //! A queued SlicedSave item, which saves a set of objects in one call
+        template <class CRPSArchive, class ... Types>
+        struct SlicedItem
+        {
+            CRPSArchive* crps_archive;       //!< Archive the objects are saved to
+            std::tuple<Types*...> objects;   //!< Objects to be saved, owned by the user
+
+            bool operator()(std::chrono::steady_clock::time_point)
+            {
+                save(make_index_sequence<sizeof...(Types)>{});
+                return true;
+            }
+
+            template <std::size_t ... Indices>
+            void save(index_sequence<Indices...>)
+            {
+                (*crps_archive)(*std::get<Indices>(objects)...);
+            }
+        };
+
+        //! A queued SlicedSave item, which saves the elements of a vector over any number of calls
+        template <class CRPSArchive, class T, class A>
+        struct SlicedElements
+        {
+            CRPSArchive* crps_archive;          //!< Archive the elements are saved to
+            std::vector<T, A>* elements;        //!< Vector owned by the user
+            std::size_t position;               //!< Index of the next element, or size() + 1 before the size is saved
+
+            bool operator()(std::chrono::steady_clock::time_point deadline)
+            {
+                static const std::size_t check_interval = 16;
+
+                if (position > elements->size()) {
+                    (*crps_archive)(cereal::make_size_tag(static_cast<cereal::size_type>(elements->size())));
+                    position = 0;
+                }
+
+                while (position < elements->size())
+                {
+                    (*crps_archive)((*elements)[position++]);
+
+                    if (position % check_interval == 0 && position < elements->size() && std::chrono::steady_clock::now() >= deadline) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+        };
+    }
+
+    // ######################################################################
+    //! Saves through a CRPSOutputArchive in time slices.
+    /*! Objects are queued with operator() and elements(), and are saved by
+        repeated calls to step(), each of which returns once its budget is spent.
+        The traversal state of the CRPSOutputArchive is kept between calls, and
+        the final calls generate and save the pointer book-keeping in slices
+        using CRPSOutputArchive::complete_step. This allows a large save to run
+        on a latency sensitive thread, such as an event loop, between frames.
+
+        A step cannot be interrupted inside the traversal of an object, so the
+        granularity of a slice is one queued object, or one element of a queued
+        vector, and a step overruns its budget by up to one such item. Deferments,
+        such as objects of cereal::defer, are all saved by the first step after the
+        queue is empty, as by CRPSOutputArchive::complete_step. Queued objects are
+        held by reference and must neither be modified nor moved until the save
+        is done.
+
+        Example:
+        @code{cpp}
+        crps::SlicedSave<cereal::BinaryOutputArchive> sliced(crps_oarchive);
+        sliced(header).elements(vertices).elements(edges);
+        ...
+        // once per frame
+        if (sliced.step(std::chrono::milliseconds(2))) {
+            // save is done
+        }
+        @endcode
+
+        @ingroup Utility */
+    template <class Archive, class ... Archives>
+    class SlicedSave
+    {
+    public:
+
+        using CRPSArchive = CRPSOutputArchive<Archive, Archives...>;
+
+        /*! @param crps_archive The archive to save to, which must outlive the SlicedSave */
+        SlicedSave(CRPSArchive& crps_archive) :
+            crps_archive(crps_archive)
+        {
+
+        }
+
+        //! Queues objects to be saved together, as by crps_archive(args...)
+        template <class ... Types>
+        SlicedSave& operator()(Types& ... args)
+        {
+            items.push_back(detail::SlicedItem<CRPSArchive, Types...>{ &crps_archive, std::tuple<Types*...>(std::addressof(args)...) });
+            return *this;
+        }
+
+        /*! Queues a vector to be saved one element at a time. The output matches
+            crps_archive(vector) for archives that save vectors as a size tag
+            followed by the elements, such as cereal::BinaryOutputArchive.
+            Vectors of arithmetic types are saved by cereal as one block of binary
+            data, which is neither traversed nor sliced, and should be queued with
+            operator() instead. */
+        template <class T, class A>
+        SlicedSave& elements(std::vector<T, A>& vector)
+        {
+            static_assert(!std::is_arithmetic<T>::value, "Vectors of arithmetic types must be queued with operator()");
+
+            items.push_back(detail::SlicedElements<CRPSArchive, T, A>{ &crps_archive, &vector, vector.size() + 1 });
+            return *this;
+        }
+
+        /*! Continues the save for about budget, and at least one queued object or
+            slice of pointer book-keeping.
+
+            @returns True once the save is done, including the pointer book-keeping
+            @throws CRPSException If pointer-booking serialization fails.
+            */
+        bool step(std::chrono::steady_clock::duration budget)
+        {
+            const auto deadline = std::chrono::steady_clock::now() + budget;
+
+            while (!items.empty())
+            {
+                if (!items.front()(deadline)) {
+                    return false;
+                }
+                items.pop_front();
+
+                if (std::chrono::steady_clock::now() >= deadline) {
+                    return done();
+                }
+            }
+
+            saved = crps_archive.complete_step(deadline);
+            return saved;
+        }
+
+        //! True once the save is done, including the pointer book-keeping
+        bool done() const
+        {
+            return saved;
+        }
+
+    private:
+        CRPSArchive& crps_archive; //!< Archive the queued objects are saved to
+
+        std::deque<std::function<bool(std::chrono::steady_clock::time_point)>> items{}; //!< Queued objects that are not yet saved
+
+        bool saved{ false }; //!< True once the pointer book-keeping is saved
+    };
+}
+}
+
+#endif
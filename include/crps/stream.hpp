@@ -0,0 +1,279 @@
+#ifndef CRPS_STREAM_HPP_
+#define CRPS_STREAM_HPP_
+
+#include "crps/crps.hpp"
+#include <deque>
+
+namespace crps
+{
+inline namespace CRPS_TRACE_NAMESPACE
+{
+    // ######################################################################
+    //! Saves a stream of records, each followed by the pointer book-keeping of its pointers.
+    /*! Each call saves one record, and the pointer-id to object-id map of
+        the pointers in the record is saved right after it, rather than at the
+        end of the save. This allows CRPSStreamInputArchive to use each record
+        as soon as it is loaded.
+
+        The objects of every record stay tracked, so pointers of a record may
+        reference objects of the same record or of earlier records, as well as
+        objects of an external graph set by setExternalObjects. Only the pointers
+        of a record are released once the record is saved. setWindow bounds the
+        tracked objects to those of the last records. Objects shared through
+        std::shared_ptr are tracked with the record that first saves them.
+        cereal::defer is not supported in records, as cereal keeps the deferments
+        of the user archive for its lifetime and would save them again with every
+        later record. The end of the stream is saved by complete, or by
+        ~CRPSStreamOutputArchive.
+
+        @code{cpp}
+        cereal::BinaryOutputArchive oarchive(stream);
+        crps::CRPSStreamOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+        for (auto& event : events) {
+            crps_oarchive(event);
+        }
+        @endcode
+
+        @ingroup Utility */
+    template <class Archive>
+    class CRPSStreamOutputArchive
+    {
+    public:
+
+        /*! @param archive The archive provided by the user, its interface is wrapped for object tracking. */
+        CRPSStreamOutputArchive(Archive& archive) : archive(archive)
+        {
+            static_assert(Archive::is_saving::value, "CRPSStreamOutputArchive<Archive> cannot be used with an input archive.");
+
+            setBackend(CRPSBackend::Automatic);
+        }
+
+        /*! Complete the stream if not completed. */
+        ~CRPSStreamOutputArchive()
+        {
+            complete();
+        }
+
+        /*! Saves the end of the stream. */
+        void complete()
+        {
+            if (completed) {
+                return;
+            }
+            completed = true;
+
+            const std::uint8_t end_of_stream = 0;
+            archive(end_of_stream);
+        }
+
+        /*! Resolves pointers to objects not saved in the stream against an external graph.
+
+            @param objects The ExternalObjects of the external graph, which must outlive the archive
+            */
+        void setExternalObjects(ExternalObjects const& objects)
+        {
+            pointer_mapper.setExternalObjects(objects);
+        }
+
+        /*! Throws a CRPSException from the record that makes the pointer book-keeping exceed limits. 
+            Objects of the records within the window count toward the limits, pointers only toward 
+            those of their record. */
+        void setLimits(CRPSLimits const& limits)
+        {
+            pointer_mapper.setLimits(limits);
+        }
+
+        /*! Selects the index of tracked objects, see CRPSOutputArchive::setBackend. Automatic selects 
+            the Hash backend, as the pointers of every record are looked up before the next record. */
+        void setBackend(CRPSBackend backend)
+        {
+            pointer_mapper.setBackend(backend == CRPSBackend::Automatic ? CRPSBackend::Hash : backend);
+        }
+
+        /*! Lets pointers of a record reference objects of the record and of the given number of 
+            records before it only, so that the book-keeping of older records is released. 
+            CRPSStreamInputArchive::setWindow must be given the same or a larger window. 
+
+            @param records Earlier records pointers may reference, 0 for every earlier record, which is the default
+            */
+        void setWindow(std::size_t records)
+        {
+            window = records;
+        }
+
+        //! Statistics of the pointer book-keeping of the tracked records, with the pointers of the last record
+        CRPSMapperStats stats() const
+        {
+            return pointer_mapper.stats();
+        }
+
+        /*! Saves args as one record, followed by the pointer book-keeping of the record.
+            @throws CRPSException If a pointer of the record does not reference an object of the record 
+                                  or of an earlier record within the window, if the record uses cereal::defer, 
+                                  or if called after complete.
+        */
+        template <class ... Types> inline
+        CRPSStreamOutputArchive& operator()(Types&& ... args)
+        {
+            if (completed) {
+                throw CRPSException("Attempted serialization after CRPSStreamOutputArchive::complete called");
+            }
+
+            pointer_mapper.releasePointers();
+            if (window != 0)
+            {
+                record_first_ids.push_back(pointer_mapper.objectCount());
+                if (record_first_ids.size() > window + 1) {
+                    record_first_ids.pop_front();
+                    pointer_mapper.forgetObjects(record_first_ids.front());
+                }
+            }
+
+            pointer_mapper(std::forward<Types>(args)...);
+            if (pointer_mapper.deferments() != 0) {
+                throw CRPSException("cereal::defer is not supported by CRPSStreamOutputArchive records");
+            }
+            const std::vector<std::uint32_t> raw_to_obj = pointer_mapper.pointerTable();
+
+            const std::uint8_t record = 1;
+            archive(record);
+            archive(std::forward<Types>(args)...);
+            archive(raw_to_obj);
+            return *this;
+        }
+
+    private:
+        Archive& archive; //!< User provided serialization archive
+
+        CRPSOutputMapper pointer_mapper{}; //!< Tracks the objects of every record, and the pointers of the last record
+
+        std::size_t window{ 0 }; //!< Earlier records pointers may reference, 0 for every earlier record
+
+        std::deque<std::uint32_t> record_first_ids{}; //!< Object-id of the first object of each record within the window, if set
+
+        bool completed{ false }; //!< True if the end of the stream has been saved
+    };
+
+    // ######################################################################
+    //! Loads a stream of records saved by CRPSStreamOutputArchive, one record at a time.
+    /*! Each call to next loads one record and initializes its pointers, so
+        the record may be used before the rest of the stream is loaded.
+
+        The objects of every record stay tracked, so pointers of a record may
+        reference objects of earlier records, which must therefore neither be
+        destroyed nor moved while later records are loaded, for example by loading
+        into the elements of a std::deque. Only the pointers of a record are released
+        once they are initialized. setWindow bounds the tracked objects to those of
+        the last records, as set on CRPSStreamOutputArchive.
+
+        @code{cpp}
+        cereal::BinaryInputArchive iarchive(stream);
+        crps::CRPSStreamInputArchive<cereal::BinaryInputArchive> crps_iarchive(iarchive);
+        std::deque<Event> events(1);
+        while (crps_iarchive.next(events.back())) {
+            process(events.back());
+            events.emplace_back();
+        }
+        @endcode
+
+        @ingroup Utility */
+    template <class Archive>
+    class CRPSStreamInputArchive
+    {
+    public:
+
+        /*! @param archive The archive provided by the user, its interface is wrapped for object tracking. */
+        CRPSStreamInputArchive(Archive& archive) : archive(archive)
+        {
+            static_assert(Archive::is_loading::value, "CRPSStreamInputArchive<Archive> cannot be used with an output archive.");
+        }
+
+        /*! Resolves external object-ids saved by CRPSStreamOutputArchive::setExternalObjects
+            against the objects of an external graph.
+
+            @param objects The ExternalObjects of the loaded external graph, which must outlive the archive
+            */
+        void setExternalObjects(ExternalObjects const& objects)
+        {
+            pointer_mapper.setExternalObjects(objects);
+        }
+
+        /*! Throws a CRPSException from the record that makes the pointer book-keeping exceed limits. 
+            Objects of the records within the window count toward the limits, pointers only toward 
+            those of their record. */
+        void setLimits(CRPSLimits const& limits)
+        {
+            pointer_mapper.setLimits(limits);
+        }
+
+        /*! Releases the book-keeping of the objects of records older than the window. 
+            @param records Earlier records pointers may reference, at least the window of CRPSStreamOutputArchive::setWindow, 
+                           or 0 for every earlier record, which is the default
+            */
+        void setWindow(std::size_t records)
+        {
+            window = records;
+        }
+
+        /*! Loads the next record into args, and initializes its pointers.
+
+            @returns False if the end of the stream is reached, in which case args are not loaded
+            @throws CRPSException If the pointer book-keeping of the record does not match its traversal, 
+                                  if a pointer references an object of a record older than the window, 
+                                  or if the record uses cereal::defer.
+            */
+        template <class ... Types> inline
+        bool next(Types&& ... args)
+        {
+            if (ended) {
+                return false;
+            }
+
+            std::uint8_t record;
+            archive(record);
+            if (record == 0) {
+                ended = true;
+                return false;
+            }
+
+            pointer_mapper.releasePointers();
+            if (window != 0)
+            {
+                record_first_ids.push_back(pointer_mapper.objectCount());
+                if (record_first_ids.size() > window + 1) {
+                    record_first_ids.pop_front();
+                    pointer_mapper.forgetObjects(record_first_ids.front());
+                }
+            }
+
+            archive(std::forward<Types>(args)...);
+            pointer_mapper(std::forward<Types>(args)...);
+            if (pointer_mapper.deferments() != 0) {
+                throw CRPSException("cereal::defer is not supported by CRPSStreamInputArchive records");
+            }
+
+            pointer_mapper.restorePointers(pointer_mapper.loadPointerTable(archive));
+            return true;
+        }
+
+        //! True once the end of the stream has been loaded
+        bool done() const
+        {
+            return ended;
+        }
+
+    private:
+        Archive& archive; //!< User provided serialization archive
+
+        CRPSInputMapper pointer_mapper{}; //!< Tracks the objects of every record, and the pointers of the last record
+
+        std::size_t window{ 0 }; //!< Earlier records whose objects are tracked, 0 for every earlier record
+
+        std::deque<std::uint32_t> record_first_ids{}; //!< Object-id of the first object of each record within the window, if set
+
+        bool ended{ false }; //!< True if the end of the stream has been loaded
+    };
+}
+}
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef CRPS_TRACE_HPP_
+#define CRPS_TRACE_HPP_
+
+#include "crps/crps.hpp"
+#include <fstream>
+#include <locale>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace crps
+{
+    // ######################################################################
+    //! A CRPSTraceSink that writes trace events in the Chrome trace event format.
+    /*! Each phase is written as a complete event of category "crps", with the
+        tracked objects and pointers as arguments when counted. The output is a
+        JSON array that can be opened by chrome://tracing and Perfetto, and is
+        closed by ~ChromeTraceSink.
+
+        Timestamps are microseconds of std::chrono::steady_clock, which is the
+        monotonic clock of the platform, so the events line up with other traces
+        of the process that use the same clock. Events carry the id of the
+        process, so traces of several processes can be merged. Each event is
+        formatted apart from the stream, whose flags and locale are left as set
+        by the caller.
+
+        @code{cpp}
+        #define CRPS_ENABLE_TRACE
+        #include <crps/trace.hpp>
+
+        crps::ChromeTraceSink sink("crps_trace.json");
+        crps::set_trace_sink(&sink);
+        save_checkpoint();
+        crps::set_trace_sink(nullptr);
+        @endcode
+
+        @ingroup Utility */
+    class ChromeTraceSink : public CRPSTraceSink
+    {
+    public:
+
+        /*! @param path The file the trace is written to, which is replaced
+            @throws CRPSException If the file cannot be opened. */
+        explicit ChromeTraceSink(std::string const& path) : file(new std::ofstream(path, std::ios::binary)), stream(*file), pid(processId())
+        {
+            if (!*file) {
+                throw CRPSException("Failed to open trace file " + path);
+            }
+            stream << "[";
+        }
+
+        /*! @param stream The stream the trace is written to, which must outlive the sink */
+        explicit ChromeTraceSink(std::ostream& stream) : stream(stream), pid(processId())
+        {
+            stream << "[";
+        }
+
+        /*! Closes the JSON array of events. */
+        ~ChromeTraceSink() override
+        {
+            stream << "\n]\n";
+            stream.flush();
+        }
+
+        ChromeTraceSink(ChromeTraceSink const&) = delete;
+        ChromeTraceSink& operator=(ChromeTraceSink const&) = delete;
+
+        //! Writes the event as a complete event on the current thread
+        void event(CRPSTraceEvent const& event) override
+        {
+            using microseconds = std::chrono::duration<double, std::micro>;
+            const double begin = std::chrono::duration_cast<microseconds>(event.begin.time_since_epoch()).count();
+            const double duration = std::chrono::duration_cast<microseconds>(event.end - event.begin).count();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            std::ostringstream line;
+            line.imbue(std::locale::classic());
+            line << (first ? "\n" : ",\n") << std::fixed
+                 << "{\"name\":\"" << event.name << "\",\"cat\":\"crps\",\"ph\":\"X\""
+                 << ",\"ts\":" << begin << ",\"dur\":" << duration
+                 << ",\"pid\":" << pid << ",\"tid\":" << threadNumber(std::this_thread::get_id());
+            if (event.counted) {
+                line << ",\"args\":{\"objects\":" << event.objects << ",\"pointers\":" << event.pointers << "}";
+            }
+            line << "}";
+            stream << line.str();
+            first = false;
+        }
+
+    private:
+
+        //! Id of the current process
+        static long processId()
+        {
+#ifdef _WIN32
+            return static_cast<long>(_getpid());
+#else
+            return static_cast<long>(getpid());
+#endif
+        }
+
+        //! Small number of a thread, in the order threads first reported an event
+        std::size_t threadNumber(std::thread::id thread)
+        {
+            auto it = threads.find(thread);
+            if (it == threads.end()) {
+                it = threads.emplace(thread, threads.size() + 1).first;
+            }
+            return it->second;
+        }
+
+    private:
+        std::unique_ptr<std::ofstream> file{}; //!< File the trace is written to, if opened by the sink
+
+        std::ostream& stream; //!< Stream the trace is written to
+
+        const long pid; //!< Id of the process, written with every event
+
+        std::mutex mutex{}; //!< Serializes events reported by several threads
+
+        std::map<std::thread::id, std::size_t> threads{}; //!< Number of each thread that reported an event
+
+        bool first{ true }; //!< True until the first event is written
+    };
+}
+
+#endif
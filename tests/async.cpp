@@ -0,0 +1,66 @@
+#include "check.hpp"
+#include "graph.hpp"
+
+using crps_test::Mesh;
+using crps_test::Edge;
+
+int main()
+{
+    Mesh mesh{};
+    mesh.build(500);
+    const std::string plain = crps_test::saveCRPS(mesh);
+
+    // The book-keeping resolved on a worker thread is saved like complete saves it,
+    // and the user archive may be used once the future is waited on
+    std::ostringstream stream;
+    {
+        cereal::BinaryOutputArchive oarchive(stream);
+        crps::CRPSOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+        crps_oarchive(mesh);
+        std::future<void> completion = crps_oarchive.complete_async();
+        completion.get();
+        std::uint32_t trailer = 12345;
+        oarchive(trailer);
+    }
+    const std::string bytes = stream.str();
+    CRPS_CHECK(bytes.compare(0, plain.size(), plain) == 0);
+
+    // A completion that is never waited on is finished by the destructor
+    {
+        std::ostringstream unwaited;
+        {
+            cereal::BinaryOutputArchive oarchive(unwaited);
+            crps::CRPSOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+            crps_oarchive(mesh);
+            crps_oarchive.complete_async();
+        }
+        CRPS_CHECK(unwaited.str() == plain);
+    }
+
+    // Pointers are initialized on a worker thread while the user archive reads on
+    Mesh loaded{};
+    std::uint32_t trailer = 0;
+    {
+        std::istringstream input(bytes);
+        cereal::BinaryInputArchive iarchive(input);
+        crps::CRPSInputArchive<cereal::BinaryInputArchive> crps_iarchive(iarchive);
+        crps_iarchive(loaded);
+        std::future<void> completion = crps_iarchive.complete_async();
+        iarchive(trailer);
+        completion.get();
+    }
+    CRPS_CHECK(trailer == 12345);
+    CRPS_CHECK(loaded.matches(500));
+
+    // A pointer to an object that is not serialized throws from the future
+    std::vector<Edge> dangling = { Edge{ &mesh.vertices[0], nullptr, nullptr } };
+    {
+        std::ostringstream output;
+        cereal::BinaryOutputArchive oarchive(output);
+        crps::CRPSOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+        crps_oarchive(dangling);
+        std::future<void> completion = crps_oarchive.complete_async();
+        CRPS_CHECK_THROWS(completion.get(), crps::CRPSException);
+    }
+    return 0;
+}
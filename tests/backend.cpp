@@ -0,0 +1,144 @@
+#include "check.hpp"
+#include "graph.hpp"
+
+#include <crps/binary.hpp>
+#include <crps/stream.hpp>
+
+#include <memory>
+
+namespace crps_test
+{
+    //! A node allocated on its own, with pointers to the weights of other nodes
+    struct HeapNode
+    {
+        std::vector<std::uint8_t> padding;
+        float weight;
+        std::vector<crps::raw_ptr<float>> refs;
+
+        template <class Archive>
+        void serialize(Archive& ar) { ar(padding, weight, refs, crps::this_ptr(this)); }
+    };
+
+    //! Creates count nodes scattered between allocations of varying size, with refs pointers each
+    std::vector<std::unique_ptr<HeapNode>> buildHeap(std::size_t count, std::size_t refs)
+    {
+        std::vector<std::unique_ptr<HeapNode>> nodes{};
+        std::vector<std::unique_ptr<char[]>> gaps{};
+        for (std::size_t i = 0; i < count; i++)
+        {
+            nodes.emplace_back(new HeapNode{ {}, static_cast<float>(i), {} });
+            gaps.emplace_back(new char[16 + (i * 7919) % 200]);
+        }
+        for (std::size_t i = 0; i < count; i++)
+        {
+            for (std::size_t k = 0; k < refs; k++) {
+                nodes[i]->refs.push_back(&nodes[(i * 31 + 7 + k) % count]->weight);
+            }
+        }
+        return nodes;
+    }
+
+    //! Saves the nodes with backend, and returns the stats of the save in stats
+    std::string saveHeap(std::vector<std::unique_ptr<HeapNode>> const& nodes, crps::CRPSBackend backend, crps::CRPSMapperStats& stats)
+    {
+        std::ostringstream stream;
+        cereal::BinaryOutputArchive oarchive(stream);
+        crps::CRPSOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+        crps_oarchive.setBackend(backend);
+        for (std::unique_ptr<HeapNode> const& node : nodes) {
+            crps_oarchive(*node);
+        }
+        stats = crps_oarchive.stats();
+        crps_oarchive.complete();
+        return stream.str();
+    }
+}
+
+using crps_test::HeapNode;
+
+int main()
+{
+    const std::size_t count = 10000;
+    for (std::size_t refs : { std::size_t(1), std::size_t(32) })
+    {
+        const std::vector<std::unique_ptr<HeapNode>> nodes = crps_test::buildHeap(count, refs);
+
+        // Every backend saves the same output, and sampling picks the backend from the pointers per indexed object
+        crps::CRPSMapperStats hash_stats{};
+        crps::CRPSMapperStats sorted_stats{};
+        crps::CRPSMapperStats automatic_stats{};
+        const std::string hash = crps_test::saveHeap(nodes, crps::CRPSBackend::Hash, hash_stats);
+        const std::string sorted = crps_test::saveHeap(nodes, crps::CRPSBackend::SortedLog, sorted_stats);
+        const std::string automatic = crps_test::saveHeap(nodes, crps::CRPSBackend::Automatic, automatic_stats);
+        CRPS_CHECK(hash == sorted && sorted == automatic);
+
+        CRPS_CHECK(hash_stats.backend == crps::CRPSBackend::Hash && !hash_stats.automatic);
+        CRPS_CHECK(sorted_stats.backend == crps::CRPSBackend::SortedLog && !sorted_stats.automatic);
+        CRPS_CHECK(automatic_stats.automatic);
+        CRPS_CHECK(automatic_stats.backend == (refs == 32 ? crps::CRPSBackend::Hash : crps::CRPSBackend::SortedLog));
+        CRPS_CHECK(automatic_stats.pointers == count * refs);
+        CRPS_CHECK(automatic_stats.objects == hash_stats.objects && automatic_stats.objects == sorted_stats.objects);
+
+        std::ostringstream native;
+        {
+            crps::BinaryOutputArchive oarchive(native);
+            oarchive.setBackend(crps::CRPSBackend::SortedLog);
+            for (std::unique_ptr<HeapNode> const& node : nodes) {
+                oarchive(*node);
+            }
+        }
+        CRPS_CHECK(native.str() == hash);
+
+        std::istringstream input(automatic);
+        cereal::BinaryInputArchive iarchive(input);
+        crps::CRPSInputArchive<cereal::BinaryInputArchive> crps_iarchive(iarchive);
+        std::vector<HeapNode> loaded(count);
+        for (HeapNode& node : loaded) {
+            crps_iarchive(node);
+        }
+        crps_iarchive.complete();
+        for (std::size_t i = 0; i < count; i++)
+        {
+            for (std::size_t k = 0; k < refs; k++) {
+                CRPS_CHECK(loaded[i].refs[k].ptr == &loaded[(i * 31 + 7 + k) % count].weight);
+            }
+        }
+    }
+
+    // Past a cache-sized index, sampling turns to the sorted log at a density that picks the hash map above
+    {
+        const std::vector<std::unique_ptr<HeapNode>> nodes = crps_test::buildHeap(60000, 16);
+        crps::CRPSMapperStats sorted_stats{};
+        crps::CRPSMapperStats automatic_stats{};
+        const std::string sorted = crps_test::saveHeap(nodes, crps::CRPSBackend::SortedLog, sorted_stats);
+        const std::string automatic = crps_test::saveHeap(nodes, crps::CRPSBackend::Automatic, automatic_stats);
+        CRPS_CHECK(sorted == automatic);
+        CRPS_CHECK(automatic_stats.automatic && automatic_stats.backend == crps::CRPSBackend::SortedLog);
+        CRPS_CHECK(automatic_stats.pointers >= 4 * automatic_stats.table_entries);
+    }
+
+    // Stream archives sort the entries of each record of two nodes into the sorted log
+    {
+        const std::vector<std::unique_ptr<HeapNode>> nodes = crps_test::buildHeap(3000, 0);
+        for (std::size_t i = 0; i < nodes.size(); i++) {
+            nodes[i]->refs.push_back(&nodes[i ^ 1]->weight);
+        }
+        std::string outputs[2];
+        const crps::CRPSBackend backends[2] = { crps::CRPSBackend::Hash, crps::CRPSBackend::SortedLog };
+        for (std::size_t b = 0; b < 2; b++)
+        {
+            std::ostringstream stream;
+            {
+                cereal::BinaryOutputArchive oarchive(stream);
+                crps::CRPSStreamOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+                crps_oarchive.setBackend(backends[b]);
+                for (std::size_t i = 0; i < nodes.size(); i += 2) {
+                    crps_oarchive(*nodes[i], *nodes[i + 1]);
+                }
+            }
+            outputs[b] = stream.str();
+        }
+        CRPS_CHECK(outputs[0] == outputs[1]);
+    }
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include "check.hpp"
+#include "graph.hpp"
+
+#include <cereal/types/memory.hpp>
+#include <crps/binary.hpp>
+
+#include <memory>
+#include <stdexcept>
+
+using crps_test::Mesh;
+using crps_test::Vertex;
+
+namespace crps_test
+{
+    //! A vertex pointed to through this_ptr, with a vector of arithmetic type written as one block
+    struct Anchor
+    {
+        Vertex vertex;
+        std::vector<double> samples;
+        std::shared_ptr<Vertex> shared;
+
+        template <class Archive>
+        void serialize(Archive& ar) { ar(vertex, samples, shared, crps::this_ptr(this)); }
+    };
+
+    //! Throws from its serialization, after the values before it are tracked
+    struct Failing
+    {
+        template <class Archive>
+        void serialize(Archive&) { throw std::runtime_error("failing serialization"); }
+    };
+}
+
+using crps_test::Anchor;
+using crps_test::Failing;
+
+int main()
+{
+    Mesh mesh{};
+    mesh.build(1000);
+    Anchor anchor{ Vertex{ 3, 4.0f }, { 1.5, 2.5, 3.5 }, std::make_shared<Vertex>(Vertex{ 9, 1.0f }) };
+    Anchor* anchor_ptr = &anchor;
+
+    // A small buffer forces blocks both through and around the buffer
+    std::ostringstream native;
+    {
+        crps::BinaryOutputArchive oarchive(native, 64);
+        oarchive(mesh, crps::make_raw_ptr(anchor_ptr), anchor);
+    }
+    const std::string wrapped = crps_test::saveCRPS(mesh, crps::make_raw_ptr(anchor_ptr), anchor);
+    CRPS_CHECK(native.str() == wrapped);
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        Mesh loaded{};
+        Anchor loaded_anchor{};
+        Anchor* loaded_ptr = nullptr;
+        std::istringstream input(native.str());
+        if (pass == 0)
+        {
+            crps::BinaryInputArchive iarchive(input);
+            iarchive(loaded, crps::make_raw_ptr(loaded_ptr), loaded_anchor);
+            iarchive.complete();
+        }
+        else
+        {
+            cereal::BinaryInputArchive iarchive(input);
+            crps::CRPSInputArchive<cereal::BinaryInputArchive> crps_iarchive(iarchive);
+            crps_iarchive(loaded, crps::make_raw_ptr(loaded_ptr), loaded_anchor);
+        }
+        CRPS_CHECK(loaded.matches(1000));
+        CRPS_CHECK(loaded_ptr == &loaded_anchor);
+        CRPS_CHECK(loaded_anchor.samples.size() == 3 && loaded_anchor.samples[2] == 3.5);
+        CRPS_CHECK(loaded_anchor.shared->id == 9);
+    }
+
+    // A pointer to an object that is not serialized throws from complete
+    {
+        std::ostringstream output;
+        crps::BinaryOutputArchive oarchive(output);
+        oarchive(crps::make_raw_ptr(anchor_ptr));
+        CRPS_CHECK_THROWS(oarchive.complete(), crps::CRPSException);
+    }
+
+    // A failed serialization leaves the archives completed, so the destructors do not complete a partial traversal
+    Failing failing{};
+    {
+        std::ostringstream output;
+        crps::BinaryOutputArchive oarchive(output);
+        CRPS_CHECK_THROWS(oarchive(crps::make_raw_ptr(anchor_ptr), failing), std::runtime_error);
+        CRPS_CHECK_THROWS(oarchive(anchor), crps::CRPSException);
+    }
+    {
+        Mesh loaded{};
+        Anchor* loaded_ptr = nullptr;
+        std::istringstream input(native.str());
+        crps::BinaryInputArchive iarchive(input);
+        CRPS_CHECK_THROWS(iarchive(loaded, crps::make_raw_ptr(loaded_ptr), failing), std::runtime_error);
+        CRPS_CHECK_THROWS(iarchive(loaded), crps::CRPSException);
+    }
+    return 0;
+}
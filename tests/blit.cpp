@@ -0,0 +1,157 @@
+#include "check.hpp"
+#include "graph.hpp"
+
+#include <crps/binary.hpp>
+
+#include <cstring>
+
+using crps_test::Vertex;
+
+namespace crps_test
+{
+    //! Vertices saved as one block, with links to them
+    struct Cloud
+    {
+        std::vector<Vertex> vertices;
+        std::vector<crps::raw_ptr<Vertex>> links;
+
+        template <class Archive>
+        void serialize(Archive& ar) { ar(crps::blit(vertices), links); }
+
+        //! Creates count vertices, and links in a pattern that depends on count only
+        void build(std::size_t count)
+        {
+            for (std::size_t i = 0; i < count; i++) {
+                vertices.push_back(Vertex{ static_cast<std::uint32_t>(i), static_cast<float>(i) });
+            }
+            for (std::size_t i = 0; i < count; i++) {
+                links.push_back(&vertices[(i * 11 + 5) % count]);
+            }
+        }
+
+        //! True if the cloud has the values and links created by build(count), with links into this cloud
+        bool matches(std::size_t count) const
+        {
+            if (vertices.size() != count || links.size() != count) {
+                return false;
+            }
+            for (std::size_t i = 0; i < count; i++)
+            {
+                if (vertices[i].id != i || links[i].ptr != &vertices[(i * 11 + 5) % count]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+}
+
+using crps_test::Cloud;
+
+int main()
+{
+    Cloud cloud{};
+    cloud.build(3000);
+    const std::string bytes = crps_test::saveCRPS(cloud);
+
+    Cloud loaded{};
+    crps_test::loadCRPS(bytes, loaded);
+    CRPS_CHECK(loaded.matches(3000));
+
+    // The native archives write and track blit arrays alike
+    std::ostringstream native;
+    {
+        crps::BinaryOutputArchive oarchive(native);
+        oarchive(cloud);
+    }
+    CRPS_CHECK(native.str() == bytes);
+    Cloud native_loaded{};
+    {
+        std::istringstream input(bytes);
+        crps::BinaryInputArchive iarchive(input);
+        iarchive(native_loaded);
+        iarchive.complete();
+    }
+    CRPS_CHECK(native_loaded.matches(3000));
+
+    // Each element takes one object-id, its members none
+    {
+        crps::CRPSOutputMapper mapper{};
+        mapper(cloud.vertices.size(), crps::blit(cloud.vertices));
+        CRPS_CHECK(mapper.stats().objects == 1 + cloud.vertices.size());
+    }
+
+    // Pointers to members of the elements are saved as their element and offset, after the pointers
+    Cloud member{};
+    member.build(10);
+    std::vector<crps::raw_ptr<float>> weights = { &member.vertices[3].weight, &member.vertices[9].weight };
+    std::vector<crps::raw_ptr<std::uint32_t>> ids = { &member.vertices[7].id };
+    const std::string member_bytes = crps_test::saveCRPS(member, weights, ids);
+    {
+        std::ostringstream member_native;
+        {
+            crps::BinaryOutputArchive oarchive(member_native);
+            oarchive(member, weights, ids);
+        }
+        CRPS_CHECK(member_native.str() == member_bytes);
+    }
+    for (int pass = 0; pass < 2; pass++)
+    {
+        Cloud member_loaded{};
+        std::vector<crps::raw_ptr<float>> loaded_weights{};
+        std::vector<crps::raw_ptr<std::uint32_t>> loaded_ids{};
+        if (pass == 0) {
+            crps_test::loadCRPS(member_bytes, member_loaded, loaded_weights, loaded_ids);
+        }
+        else
+        {
+            std::istringstream input(member_bytes);
+            crps::BinaryInputArchive iarchive(input);
+            iarchive(member_loaded, loaded_weights, loaded_ids);
+            iarchive.complete();
+        }
+        CRPS_CHECK(member_loaded.matches(10));
+        CRPS_CHECK(loaded_weights[0].ptr == &member_loaded.vertices[3].weight);
+        CRPS_CHECK(loaded_weights[1].ptr == &member_loaded.vertices[9].weight);
+        CRPS_CHECK(loaded_ids[0].ptr == &member_loaded.vertices[7].id);
+    }
+
+    // An offset beyond its element is rejected
+    {
+        std::string corrupted = member_bytes;
+        const std::uint32_t offset = sizeof(Vertex);
+        std::memcpy(&corrupted[corrupted.size() - sizeof(offset)], &offset, sizeof(offset));
+        Cloud member_loaded{};
+        std::vector<crps::raw_ptr<float>> loaded_weights{};
+        std::vector<crps::raw_ptr<std::uint32_t>> loaded_ids{};
+        std::istringstream input(corrupted);
+        crps::BinaryInputArchive iarchive(input);
+        iarchive(member_loaded, loaded_weights, loaded_ids);
+        CRPS_CHECK_THROWS(iarchive.complete(), crps::CRPSException);
+    }
+
+    // Links of an overlay into a blit array of a base graph
+    crps::ExternalObjects saved_base{};
+    saved_base(cloud);
+    std::vector<crps::raw_ptr<Vertex>> overlay = { &cloud.vertices[0], &cloud.vertices[2999] };
+    std::ostringstream overlay_stream;
+    {
+        cereal::BinaryOutputArchive oarchive(overlay_stream);
+        crps::CRPSOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+        crps_oarchive.setExternalObjects(saved_base);
+        crps_oarchive(overlay);
+    }
+    crps::ExternalObjects loaded_base(false);
+    loaded_base(loaded);
+    std::vector<crps::raw_ptr<Vertex>> loaded_overlay{};
+    {
+        std::istringstream input(overlay_stream.str());
+        cereal::BinaryInputArchive iarchive(input);
+        crps::CRPSInputArchive<cereal::BinaryInputArchive> crps_iarchive(iarchive);
+        crps_iarchive.setExternalObjects(loaded_base);
+        crps_iarchive(loaded_overlay);
+    }
+    CRPS_CHECK(loaded_overlay[0].ptr == &loaded.vertices[0]);
+    CRPS_CHECK(loaded_overlay[1].ptr == &loaded.vertices[2999]);
+    return 0;
+}
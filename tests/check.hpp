@@ -0,0 +1,32 @@
+#ifndef CRPS_TESTS_CHECK_HPP_
+#define CRPS_TESTS_CHECK_HPP_
+
+#include <cstdio>
+#include <cstdlib>
+
+//! Reports a failed condition with its location and ends the test with a failure
+#define CRPS_CHECK(condition)                                                                   \
+    do {                                                                                        \
+        if (!(condition)) {                                                                     \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);  \
+            std::exit(1);                                                                       \
+        }                                                                                       \
+    } while (false)
+
+//! Checks that statement throws an exception of type Exception
+#define CRPS_CHECK_THROWS(statement, Exception)                                                 \
+    do {                                                                                        \
+        bool crps_thrown = false;                                                               \
+        try {                                                                                   \
+            statement;                                                                          \
+        }                                                                                       \
+        catch (Exception const&) {                                                              \
+            crps_thrown = true;                                                                 \
+        }                                                                                       \
+        if (!crps_thrown) {                                                                     \
+            std::fprintf(stderr, "%s:%d: expected %s from: %s\n", __FILE__, __LINE__, #Exception, #statement); \
+            std::exit(1);                                                                       \
+        }                                                                                       \
+    } while (false)
+
+#endif
@@ -0,0 +1,113 @@
+#include "check.hpp"
+
+#include <cereal/types/memory.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+#include <crps/clone.hpp>
+
+namespace
+{
+    struct Vertex
+    {
+        float targetA;
+        float targetB;
+        std::string name;
+
+        template <class Archive>
+        void serialize(Archive& ar) { ar(targetA, targetB, name); }
+    };
+
+    struct Edge
+    {
+        std::shared_ptr<Vertex> vertex;
+        crps::raw_ptr<float> target;
+
+        template <class Archive>
+        void serialize(Archive& ar) { ar(vertex, target); }
+    };
+
+    struct Value
+    {
+        float x;
+
+        template <class Archive>
+        void serialize(Archive& ar) { ar(x); }
+
+        bool operator==(Value const& other) const { return x == other.x; }
+    };
+
+    //! Holds pointers into itself, which a clone returned by value would leave dangling
+    struct Graph
+    {
+        std::vector<Value> values;
+        std::vector<crps::raw_ptr<Value>> selected;
+        std::vector<Edge> edges;
+
+        template <class Archive>
+        void serialize(Archive& ar) { ar(values, selected, edges); }
+    };
+
+    //! Saves a 32-bit count but loads a 64-bit one, so its clone traversals differ
+    struct Mismatched
+    {
+        std::vector<float> samples;
+
+        template <class Archive>
+        void save(Archive& ar) const { ar(static_cast<std::uint32_t>(samples.size()), samples); }
+
+        template <class Archive>
+        void load(Archive& ar)
+        {
+            std::uint64_t size = 0;
+            ar(size, samples);
+        }
+    };
+}
+
+int main()
+{
+    std::shared_ptr<Vertex> first = std::make_shared<Vertex>(Vertex{ 1.0f, 2.0f, "first" });
+    std::shared_ptr<Vertex> second = std::make_shared<Vertex>(Vertex{ 4.0f, 5.0f, "second" });
+
+    Graph source{};
+    source.values = { Value{ 0.5f }, Value{ 1.5f }, Value{ 2.5f } };
+    source.selected = { &source.values[2], &source.values[0] };
+    source.edges = { Edge{ first, &first->targetB }, Edge{ second, &second->targetA } };
+
+    Graph destination{};
+    crps::clone(source, destination);
+
+    CRPS_CHECK(destination.values == source.values);
+    CRPS_CHECK(destination.selected[0].get() == &destination.values[2]);
+    CRPS_CHECK(destination.selected[1].get() == &destination.values[0]);
+    CRPS_CHECK(destination.edges[0].vertex != first);
+    CRPS_CHECK(destination.edges[1].vertex->name == "second");
+    CRPS_CHECK(destination.edges[0].target.get() == &destination.edges[0].vertex->targetB);
+    CRPS_CHECK(destination.edges[1].target.get() == &destination.edges[1].vertex->targetA);
+
+    crps::CRPSCloneSource values_archive{};
+    values_archive(source.values);
+    CRPS_CHECK(values_archive.scalars().size() == sizeof(cereal::size_type) + 3 * sizeof(float));
+    CRPS_CHECK(values_archive.blocks().empty());
+
+    std::vector<float> samples = { 1.0f, 2.0f, 3.0f };
+    crps::CRPSCloneSource samples_archive{};
+    samples_archive(samples);
+    CRPS_CHECK(samples_archive.scalars().size() == sizeof(cereal::size_type));
+    CRPS_CHECK(samples_archive.blocks().size() == 1 && samples_archive.blocks()[0].data == samples.data());
+
+    std::vector<float> samples_copy{};
+    crps::clone(samples, samples_copy);
+    CRPS_CHECK(samples_copy == samples);
+
+    Mismatched mismatched{ samples };
+    Mismatched mismatched_copy{};
+    CRPS_CHECK_THROWS(crps::clone(mismatched, mismatched_copy), crps::CRPSException);
+
+    Graph unrelated{};
+    unrelated.values = { Value{ 1.0f } };
+    unrelated.selected = { &source.values[0] };
+    Graph failed{};
+    CRPS_CHECK_THROWS(crps::clone(unrelated, failed), crps::CRPSException);
+    return 0;
+}
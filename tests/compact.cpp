@@ -0,0 +1,128 @@
+#include "check.hpp"
+#include "graph.hpp"
+
+#include <cereal/archives/json.hpp>
+
+#include <algorithm>
+
+using crps_test::Mesh;
+using crps_test::Vertex;
+
+namespace crps_test
+{
+    //! An edge without pointers, as a text archive sees an Edge
+    struct EmptyEdge
+    {
+        template <class Archive>
+        void serialize(Archive&) {}
+    };
+
+    //! The values of a Mesh, saved and loaded by cereal alone
+    struct MeshValues
+    {
+        std::vector<Vertex> vertices;
+        std::vector<EmptyEdge> edges;
+
+        template <class Archive>
+        void serialize(Archive& ar) { ar(vertices, edges); }
+    };
+}
+
+using crps_test::MeshValues;
+
+//! Saves mesh through a CRPSOutputArchive over a cereal::JSONOutputArchive
+std::string saveJSON(Mesh const& mesh, bool compact)
+{
+    std::ostringstream stream;
+    {
+        cereal::JSONOutputArchive oarchive(stream);
+        crps::CRPSOutputArchive<cereal::JSONOutputArchive> crps_oarchive(oarchive);
+        crps_oarchive.setCompactPointers(compact);
+        crps_oarchive(mesh);
+    }
+    return stream.str();
+}
+
+//! Saves args through a cereal::JSONOutputArchive alone
+template <class ... Types>
+std::string saveCereal(Types const& ... args)
+{
+    std::ostringstream stream;
+    {
+        cereal::JSONOutputArchive oarchive(stream);
+        oarchive(args...);
+    }
+    return stream.str();
+}
+
+//! Number of objects and arrays opened in text
+std::size_t countNodes(std::string const& text)
+{
+    return static_cast<std::size_t>(std::count(text.begin(), text.end(), '{') + std::count(text.begin(), text.end(), '['));
+}
+
+int main()
+{
+    Mesh mesh{};
+    mesh.build(200);
+    crps::CRPSOutputMapper mapper{};
+    mapper(mesh);
+    const std::vector<std::uint32_t> table = mapper.pointerTable();
+
+    MeshValues values{};
+    values.vertices = mesh.vertices;
+    values.edges.resize(mesh.edges.size());
+
+    const std::string text = saveJSON(mesh, true);
+    const std::string array_text = saveJSON(mesh, false);
+
+    // Pointer wrappers add no node, so the mesh has the nodes of its values alone, 
+    // and the per-pointer array is the only node added without compact pointers
+    const std::size_t table_start = text.find("crps_pointer_count");
+    CRPS_CHECK(table_start != std::string::npos);
+    CRPS_CHECK(countNodes(text.substr(0, table_start)) == countNodes(saveCereal(values)));
+    CRPS_CHECK(countNodes(array_text) == countNodes(saveCereal(values, table)));
+
+    // The packed table holds one little-endian object-id per pointer, 
+    // decoded here by the text archive itself
+    {
+        std::istringstream input(text);
+        cereal::JSONInputArchive iarchive(input);
+        MeshValues loaded_values{};
+        cereal::size_type count = 0;
+        iarchive(loaded_values, cereal::make_nvp("crps_pointer_count", count));
+        CRPS_CHECK(count == table.size());
+        CRPS_CHECK(loaded_values.vertices.size() == mesh.vertices.size() && loaded_values.edges.size() == mesh.edges.size());
+
+        std::vector<unsigned char> bytes(table.size() * 4);
+        iarchive.loadBinaryValue(bytes.data(), bytes.size(), "crps_pointers");
+        CRPS_CHECK(table[0] == 2);
+        CRPS_CHECK(bytes[0] == 2 && bytes[1] == 0 && bytes[2] == 0 && bytes[3] == 0);
+        for (std::size_t i = 0; i < table.size(); i++)
+        {
+            const std::uint32_t id = bytes[i * 4] | bytes[i * 4 + 1] << 8 | bytes[i * 4 + 2] << 16 | static_cast<std::uint32_t>(bytes[i * 4 + 3]) << 24;
+            CRPS_CHECK(id == table[i]);
+        }
+    }
+
+    Mesh loaded{};
+    {
+        std::istringstream input(text);
+        cereal::JSONInputArchive iarchive(input);
+        crps::CRPSInputArchive<cereal::JSONInputArchive> crps_iarchive(iarchive);
+        crps_iarchive.setCompactPointers(true);
+        crps_iarchive(loaded);
+    }
+    CRPS_CHECK(loaded.matches(200));
+
+    // Without compact pointers, text archives load the per-pointer array
+    Mesh array_loaded{};
+    {
+        std::istringstream input(array_text);
+        cereal::JSONInputArchive iarchive(input);
+        crps::CRPSInputArchive<cereal::JSONInputArchive> crps_iarchive(iarchive);
+        crps_iarchive(array_loaded);
+    }
+    CRPS_CHECK(array_loaded.matches(200));
+    return 0;
+}
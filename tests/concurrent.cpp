@@ -0,0 +1,116 @@
+#include "check.hpp"
+#include "graph.hpp"
+
+#include <stdexcept>
+
+using crps_test::Mesh;
+using crps_test::Vertex;
+
+namespace crps_test
+{
+    //! Vertices saved as one blit array, with pointers into them
+    struct BlitMesh
+    {
+        std::vector<Vertex> vertices;
+        std::vector<crps::raw_ptr<Vertex>> refs;
+
+        template <class Archive>
+        void serialize(Archive& ar) { ar(crps::blit(vertices), refs); }
+    };
+
+    //! Fails to save for the user archive
+    struct Failing
+    {
+        template <class Archive>
+        void save(Archive&) const { throw std::runtime_error("failing save"); }
+    };
+
+    //! Saves each of args with one serialization per argument, with or without the concurrent mapper
+    template <class ... Types>
+    std::string saveEach(bool concurrent, Types const& ... args)
+    {
+        std::ostringstream stream;
+        {
+            cereal::BinaryOutputArchive oarchive(stream);
+            crps::CRPSOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+            crps_oarchive.setConcurrentMapper(concurrent);
+            int expand[] = { 0, (crps_oarchive(args), 0)... };
+            (void)expand;
+        }
+        return stream.str();
+    }
+}
+
+using crps_test::BlitMesh;
+using crps_test::saveEach;
+
+int main()
+{
+    // The concurrent mapper saves the same output as the sequential one
+    Mesh mesh{};
+    mesh.build(20000);
+    const std::string bytes = saveEach(true, mesh);
+    CRPS_CHECK(bytes == saveEach(false, mesh));
+    Mesh loaded{};
+    crps_test::loadCRPS(bytes, loaded);
+    CRPS_CHECK(loaded.matches(20000));
+
+    // Many small serializations reuse the worker thread
+    {
+        std::ostringstream concurrent;
+        std::ostringstream sequential;
+        for (std::ostringstream* stream : { &concurrent, &sequential })
+        {
+            cereal::BinaryOutputArchive oarchive(*stream);
+            crps::CRPSOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+            crps_oarchive.setConcurrentMapper(stream == &concurrent);
+            for (Vertex const& vertex : mesh.vertices) {
+                crps_oarchive(vertex);
+            }
+            for (crps_test::Edge const& edge : mesh.edges) {
+                crps_oarchive(edge);
+            }
+        }
+        CRPS_CHECK(concurrent.str() == sequential.str());
+    }
+
+    // Blit arrays are saved without modifying the vector the mapper reads
+    {
+        BlitMesh blitted{};
+        blitted.vertices.assign(mesh.vertices.begin(), mesh.vertices.end());
+        for (std::size_t i = 0; i < blitted.vertices.size(); i++) {
+            blitted.refs.push_back(&blitted.vertices[(i * 7 + 3) % blitted.vertices.size()]);
+        }
+        const std::string blit_bytes = saveEach(true, blitted);
+        CRPS_CHECK(blit_bytes == saveEach(false, blitted));
+
+        BlitMesh blit_loaded{};
+        crps_test::loadCRPS(blit_bytes, blit_loaded);
+        CRPS_CHECK(blit_loaded.vertices.size() == blitted.vertices.size());
+        CRPS_CHECK(blit_loaded.refs[5].ptr == &blit_loaded.vertices[38]);
+    }
+
+    // A failure of the user archive is rethrown, and completes the archive
+    {
+        std::ostringstream stream;
+        cereal::BinaryOutputArchive oarchive(stream);
+        crps::CRPSOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+        crps_oarchive.setConcurrentMapper(true);
+        crps_oarchive(mesh.vertices);
+        CRPS_CHECK_THROWS(crps_oarchive(crps_test::Failing{}), std::runtime_error);
+        CRPS_CHECK_THROWS(crps_oarchive(mesh.edges), crps::CRPSException);
+    }
+
+    // A failure of the mapper on the worker thread is rethrown on the calling thread
+    {
+        std::ostringstream stream;
+        cereal::BinaryOutputArchive oarchive(stream);
+        crps::CRPSOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+        crps_oarchive.setConcurrentMapper(true);
+        crps::CRPSLimits limits{};
+        limits.max_objects = 100;
+        crps_oarchive.setLimits(limits);
+        CRPS_CHECK_THROWS(crps_oarchive(mesh), crps::CRPSException);
+    }
+    return 0;
+}
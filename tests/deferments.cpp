@@ -0,0 +1,62 @@
+#include "check.hpp"
+
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/vector.hpp>
+#include <crps/crps.hpp>
+
+#include <sstream>
+
+namespace
+{
+    struct Node
+    {
+        int value;
+        crps::raw_ptr<Node> next;
+
+        template <class Archive>
+        void serialize(Archive& ar) { ar(value, next); }
+    };
+
+    //! Saves its nodes through cereal::defer, after the pointers into them
+    struct Graph
+    {
+        std::vector<crps::raw_ptr<Node>> roots;
+        std::vector<Node> nodes;
+
+        template <class Archive>
+        void serialize(Archive& ar) { ar(roots, cereal::defer(nodes)); }
+    };
+}
+
+int main()
+{
+    Graph source{};
+    source.nodes.resize(4);
+    for (std::size_t i = 0; i < source.nodes.size(); i++) {
+        source.nodes[i] = Node{ static_cast<int>(i), &source.nodes[(i + 1) % source.nodes.size()] };
+    }
+    source.roots = { &source.nodes[3], &source.nodes[1] };
+
+    std::stringstream stream;
+    {
+        cereal::BinaryOutputArchive oarchive(stream);
+        crps::CRPSOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+        crps_oarchive(source);
+    }
+
+    Graph loaded{};
+    {
+        cereal::BinaryInputArchive iarchive(stream);
+        crps::CRPSInputArchive<cereal::BinaryInputArchive> crps_iarchive(iarchive);
+        crps_iarchive(loaded);
+    }
+
+    CRPS_CHECK(loaded.nodes.size() == 4);
+    CRPS_CHECK(loaded.roots[0].get() == &loaded.nodes[3]);
+    CRPS_CHECK(loaded.roots[1].get() == &loaded.nodes[1]);
+    for (std::size_t i = 0; i < loaded.nodes.size(); i++) {
+        CRPS_CHECK(loaded.nodes[i].value == static_cast<int>(i));
+        CRPS_CHECK(loaded.nodes[i].next.get() == &loaded.nodes[(i + 1) % loaded.nodes.size()]);
+    }
+    return 0;
+}
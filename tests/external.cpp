@@ -0,0 +1,65 @@
+#include "check.hpp"
+#include "graph.hpp"
+
+using crps_test::Edge;
+using crps_test::Mesh;
+
+int main()
+{
+    // An overlay pointing into a base mesh, which is saved and loaded separately
+    Mesh base{};
+    base.build(100);
+    std::vector<Edge> overlay = {
+        Edge{ &base.vertices[1], &base.vertices[99], &base.vertices[50].weight },
+        Edge{ &base.vertices[7], nullptr, &base.vertices[0].weight },
+    };
+
+    crps::ExternalObjects saved_base{};
+    saved_base(base);
+    std::ostringstream stream;
+    {
+        cereal::BinaryOutputArchive oarchive(stream);
+        crps::CRPSOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+        crps_oarchive.setExternalObjects(saved_base);
+        crps_oarchive(overlay);
+    }
+
+    Mesh loaded_base{};
+    crps_test::loadCRPS(crps_test::saveCRPS(base), loaded_base);
+    crps::ExternalObjects loaded_objects(false);
+    loaded_objects(loaded_base);
+
+    std::vector<Edge> loaded_overlay{};
+    {
+        std::istringstream input(stream.str());
+        cereal::BinaryInputArchive iarchive(input);
+        crps::CRPSInputArchive<cereal::BinaryInputArchive> crps_iarchive(iarchive);
+        crps_iarchive.setExternalObjects(loaded_objects);
+        crps_iarchive(loaded_overlay);
+    }
+    CRPS_CHECK(loaded_base.matches(100));
+    CRPS_CHECK(loaded_overlay[0].from.ptr == &loaded_base.vertices[1]);
+    CRPS_CHECK(loaded_overlay[0].to.ptr == &loaded_base.vertices[99]);
+    CRPS_CHECK(loaded_overlay[0].weight.ptr == &loaded_base.vertices[50].weight);
+    CRPS_CHECK(loaded_overlay[1].to.ptr == nullptr);
+
+    // Internal object-ids must stay below the member object flag
+    std::vector<char> bytes(16);
+    {
+        crps::CRPSOutputMapper mapper{};
+        mapper.trackRange(bytes.data(), 1, crps::detail::member_object_flag - 2);
+        int last = 0;
+        mapper.trackAddress(last);
+        int beyond = 0;
+        CRPS_CHECK_THROWS(mapper.trackAddress(beyond), crps::CRPSException);
+    }
+    {
+        crps::CRPSInputMapper mapper{};
+        mapper.trackRange(bytes.data(), 1, crps::detail::member_object_flag - 2);
+        int last = 0;
+        mapper.trackAddress(last);
+        int beyond = 0;
+        CRPS_CHECK_THROWS(mapper.trackAddress(beyond), crps::CRPSException);
+    }
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include "check.hpp"
+#include "graph.hpp"
+
+#include <crps/fragment.hpp>
+
+using crps_test::Edge;
+using crps_test::Mesh;
+
+namespace
+{
+    //! Saves a and c through the cache, and b and links, which point into every mesh, as usual
+    std::string saveFragments(crps::FragmentCache<cereal::BinaryOutputArchive>& cache, Mesh const& a, std::uint64_t a_version,
+                              Mesh const& b, Mesh const& c, std::uint64_t c_version, std::vector<Edge> const& links)
+    {
+        std::ostringstream stream;
+        {
+            cereal::BinaryOutputArchive oarchive(stream);
+            crps::CRPSOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+            crps_oarchive(cache.fragment(a, a_version), b, cache.fragment(c, c_version), links);
+        }
+        return stream.str();
+    }
+
+    //! Saves or loads each of a fixed number of items in turn, as Mesh cannot be moved into a resized vector
+    template <class T>
+    struct Items
+    {
+        std::vector<T>& items;
+
+        template <class Archive>
+        void serialize(Archive& ar)
+        {
+            for (T& item : items) {
+                ar(item);
+            }
+        }
+    };
+}
+
+int main()
+{
+    Mesh a{};
+    Mesh b{};
+    Mesh c{};
+    a.build(50);
+    b.build(60);
+    c.build(70);
+    std::vector<Edge> links = {
+        Edge{ &a.vertices[3], &b.vertices[4], &c.vertices[5].weight },
+        Edge{ &c.vertices[69], &a.vertices[0], &b.vertices[59].weight },
+    };
+
+    crps::FragmentCache<cereal::BinaryOutputArchive> cache;
+    for (std::uint64_t c_version = 1; c_version <= 3; c_version++)
+    {
+        // The first save fills the cache, later saves reuse a and save c again
+        if (c_version > 1) {
+            c.vertices[10].weight += 1.0f;
+        }
+        const std::string bytes = saveFragments(cache, a, 1, b, c, c_version, links);
+        CRPS_CHECK(bytes == crps_test::saveCRPS(a, b, c, links));
+        CRPS_CHECK(cache.size() == 2);
+
+        Mesh loaded_a{};
+        Mesh loaded_b{};
+        Mesh loaded_c{};
+        std::vector<Edge> loaded_links{};
+        crps_test::loadCRPS(bytes, loaded_a, loaded_b, loaded_c, loaded_links);
+
+        CRPS_CHECK(loaded_a.matches(50));
+        CRPS_CHECK(loaded_b.matches(60));
+        CRPS_CHECK(loaded_c.vertices[10].weight == c.vertices[10].weight);
+        CRPS_CHECK(loaded_c.edges[20].to.ptr == &loaded_c.vertices[(20 * 7 + 3) % 70]);
+        CRPS_CHECK(loaded_links[0].from.ptr == &loaded_a.vertices[3]);
+        CRPS_CHECK(loaded_links[0].to.ptr == &loaded_b.vertices[4]);
+        CRPS_CHECK(loaded_links[0].weight.ptr == &loaded_c.vertices[5].weight);
+        CRPS_CHECK(loaded_links[1].from.ptr == &loaded_c.vertices[69]);
+        CRPS_CHECK(loaded_links[1].to.ptr == &loaded_a.vertices[0]);
+        CRPS_CHECK(loaded_links[1].weight.ptr == &loaded_b.vertices[59].weight);
+    }
+
+    // Links into many spliced fragments, each found by the address spans of its objects
+    std::vector<Mesh> meshes(64);
+    std::vector<crps::CachedFragment<cereal::BinaryOutputArchive>> fragments{};
+    crps::FragmentCache<cereal::BinaryOutputArchive> meshes_cache;
+    for (std::size_t i = 0; i < meshes.size(); i++)
+    {
+        meshes[i].build(10 + i % 5);
+        fragments.push_back(meshes_cache.fragment(meshes[i], 1));
+    }
+    std::vector<Edge> meshes_links{};
+    for (std::size_t i = 0; i < meshes.size(); i++) {
+        meshes_links.push_back(Edge{ &meshes[i].vertices[1], &meshes[(i * 37 + 11) % 64].vertices[2], &meshes[(i * 5 + 3) % 64].vertices[0].weight });
+    }
+    const std::string meshes_bytes = crps_test::saveCRPS(Items<crps::CachedFragment<cereal::BinaryOutputArchive>>{ fragments }, meshes_links);
+    CRPS_CHECK(meshes_bytes == crps_test::saveCRPS(Items<Mesh>{ meshes }, meshes_links));
+
+    std::vector<Mesh> loaded_meshes(meshes.size());
+    Items<Mesh> loaded_items{ loaded_meshes };
+    std::vector<Edge> loaded_meshes_links{};
+    crps_test::loadCRPS(meshes_bytes, loaded_items, loaded_meshes_links);
+    for (std::size_t i = 0; i < meshes.size(); i++)
+    {
+        CRPS_CHECK(loaded_meshes[i].matches(10 + i % 5));
+        CRPS_CHECK(loaded_meshes_links[i].from.ptr == &loaded_meshes[i].vertices[1]);
+        CRPS_CHECK(loaded_meshes_links[i].to.ptr == &loaded_meshes[(i * 37 + 11) % 64].vertices[2]);
+        CRPS_CHECK(loaded_meshes_links[i].weight.ptr == &loaded_meshes[(i * 5 + 3) % 64].vertices[0].weight);
+    }
+
+    Edge unknown{ &a.vertices[0], &b.vertices[0], &c.vertices[0].weight };
+    {
+        std::ostringstream stream;
+        cereal::BinaryOutputArchive oarchive(stream);
+        crps::CRPSOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+        crps_oarchive(Items<crps::CachedFragment<cereal::BinaryOutputArchive>>{ fragments }, unknown);
+        CRPS_CHECK_THROWS(crps_oarchive.complete(), crps::CRPSException);
+    }
+
+    std::vector<std::shared_ptr<int>> shared{ std::make_shared<int>(1) };
+    CRPS_CHECK_THROWS(cache.fragment(shared, 1), crps::CRPSException);
+    return 0;
+}
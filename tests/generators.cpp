@@ -0,0 +1,58 @@
+#include "check.hpp"
+#include "graph.hpp"
+
+#include "../bench/generators.hpp"
+
+namespace crps_test
+{
+    //! True if equal options generate equal specs, and the graph of the spec converts back to it and round trips through CRPS
+    template <class Graph, class Spec>
+    bool roundTrips(bench::WorkloadOptions const& options)
+    {
+        const Spec spec = Spec::generate(options);
+        if (!(Spec::generate(options) == spec)) {
+            return false;
+        }
+        const Graph graph(spec);
+        if (!(graph.spec() == spec)) {
+            return false;
+        }
+        const std::string bytes = saveCRPS(graph);
+        Graph loaded{};
+        loadCRPS(bytes, loaded);
+        return loaded.spec() == spec;
+    }
+}
+
+using crps_test::roundTrips;
+
+int main()
+{
+    bench::WorkloadOptions options{};
+    options.size = 3000;
+    for (bench::Direction direction : { bench::Direction::Backward, bench::Direction::Forward, bench::Direction::Mixed })
+    {
+        options.direction = direction;
+        CRPS_CHECK((roundTrips<bench::raw::Mesh<>, bench::MeshSpec>(options)));
+        CRPS_CHECK((roundTrips<bench::raw::Scene<>, bench::SceneSpec>(options)));
+        CRPS_CHECK((roundTrips<bench::raw::Scene<true>, bench::SceneSpec>(options)));
+        CRPS_CHECK((roundTrips<bench::raw::References<>, bench::ReferenceSpec>(options)));
+        CRPS_CHECK((roundTrips<bench::raw::List<>, bench::ListSpec>(options)));
+    }
+
+    // The density is the average number of pointers per node, and the seed changes the graph
+    options.density = 4.0;
+    const bench::ReferenceSpec dense = bench::ReferenceSpec::generate(options);
+    std::size_t pointers = 0;
+    for (std::vector<std::uint32_t> const& refs : dense.refs) {
+        pointers += refs.size();
+    }
+    CRPS_CHECK(pointers > 3 * options.size && pointers < 5 * options.size);
+    options.seed++;
+    CRPS_CHECK(!(bench::ReferenceSpec::generate(options) == dense));
+
+    bench::Direction parsed{};
+    CRPS_CHECK(bench::parseDirection("forward", parsed) && parsed == bench::Direction::Forward);
+    CRPS_CHECK(!bench::parseDirection("sideways", parsed));
+    return 0;
+}
@@ -0,0 +1,106 @@
+#ifndef CRPS_TESTS_GRAPH_HPP_
+#define CRPS_TESTS_GRAPH_HPP_
+
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/vector.hpp>
+#include <crps/crps.hpp>
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace crps_test
+{
+    struct Vertex
+    {
+        std::uint32_t id;
+        float weight;
+
+        template <class Archive>
+        void serialize(Archive& ar) { ar(id, weight); }
+    };
+
+    //! Points at two vertices, and into a member of a third
+    struct Edge
+    {
+        crps::raw_ptr<Vertex> from;
+        crps::raw_ptr<Vertex> to;
+        crps::raw_ptr<float> weight;
+
+        template <class Archive>
+        void serialize(Archive& ar) { ar(from, to, weight); }
+    };
+
+    //! Vertices and edges stored by value, with the edges pointing into the vertices
+    struct Mesh
+    {
+        std::vector<Vertex> vertices;
+        std::vector<Edge> edges;
+
+        Mesh() = default;
+        Mesh(Mesh const&) = delete;
+        Mesh& operator=(Mesh const&) = delete;
+
+        //! Creates count vertices and count edges, in a pattern that depends on count only
+        void build(std::size_t count)
+        {
+            vertices.clear();
+            edges.clear();
+            for (std::size_t i = 0; i < count; i++) {
+                vertices.push_back(Vertex{ static_cast<std::uint32_t>(i), static_cast<float>(i) * 0.5f });
+            }
+            for (std::size_t i = 0; i < count; i++) {
+                edges.push_back(Edge{ &vertices[i], &vertices[(i * 7 + 3) % count], &vertices[(i * 13 + 1) % count].weight });
+            }
+        }
+
+        //! True if the mesh has the values and pointer pattern created by build(count), with pointers into this mesh
+        bool matches(std::size_t count) const
+        {
+            if (vertices.size() != count || edges.size() != count) {
+                return false;
+            }
+            for (std::size_t i = 0; i < count; i++)
+            {
+                if (vertices[i].id != i || vertices[i].weight != static_cast<float>(i) * 0.5f) {
+                    return false;
+                }
+                Edge const& edge = edges[i];
+                if (edge.from.ptr != &vertices[i] || edge.to.ptr != &vertices[(i * 7 + 3) % count] ||
+                    edge.weight.ptr != &vertices[(i * 13 + 1) % count].weight) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        template <class Archive>
+        void serialize(Archive& ar) { ar(vertices, edges); }
+    };
+
+    //! Saves args through a CRPSOutputArchive over a cereal::BinaryOutputArchive
+    template <class ... Types>
+    std::string saveCRPS(Types const& ... args)
+    {
+        std::ostringstream stream;
+        {
+            cereal::BinaryOutputArchive oarchive(stream);
+            crps::CRPSOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+            crps_oarchive(args...);
+        }
+        return stream.str();
+    }
+
+    //! Loads args saved by saveCRPS through a CRPSInputArchive over a cereal::BinaryInputArchive
+    template <class ... Types>
+    void loadCRPS(std::string const& bytes, Types& ... args)
+    {
+        std::istringstream stream(bytes);
+        cereal::BinaryInputArchive iarchive(stream);
+        crps::CRPSInputArchive<cereal::BinaryInputArchive> crps_iarchive(iarchive);
+        crps_iarchive(args...);
+    }
+}
+
+#endif
@@ -0,0 +1,42 @@
+#include "check.hpp"
+#include "graph.hpp"
+
+#include <crps/hash.hpp>
+
+using crps_test::Mesh;
+
+int main()
+{
+    Mesh first{};
+    first.build(64);
+    Mesh second{};
+    second.build(64);
+
+    // Equal graphs at different addresses hash equal
+    CRPS_CHECK(&first.vertices[0] != &second.vertices[0]);
+    CRPS_CHECK(crps::hash(first) == crps::hash(second));
+
+    // So does a loaded copy
+    Mesh loaded{};
+    crps_test::loadCRPS(crps_test::saveCRPS(first), loaded);
+    CRPS_CHECK(crps::hash(loaded) == crps::hash(first));
+
+    // A value change changes the digest
+    second.vertices[10].weight += 1.0f;
+    CRPS_CHECK(crps::hash(first) != crps::hash(second));
+
+    // So does a pointer moved to another object with equal values
+    second.build(64);
+    first.vertices[40] = first.vertices[17];
+    second.vertices[40] = second.vertices[17];
+    CRPS_CHECK(crps::hash(first) == crps::hash(second));
+    CRPS_CHECK(second.edges[2].to.ptr == &second.vertices[17]);
+    second.edges[2].to = &second.vertices[40];
+    CRPS_CHECK(crps::hash(first) != crps::hash(second));
+
+    // A pointer outside the graph throws
+    crps_test::Vertex outside{ 0, 0.0f };
+    second.edges[3].from = &outside;
+    CRPS_CHECK_THROWS(crps::hash(second), crps::CRPSException);
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include "check.hpp"
+#include "graph.hpp"
+
+#include <cereal/types/memory.hpp>
+
+#include <memory>
+
+using crps_test::Mesh;
+using crps_test::Vertex;
+
+namespace crps_test
+{
+    //! Owns a mesh and a vertex through smart pointers loaded in place, with a pointer into the mesh
+    struct Scene
+    {
+        std::shared_ptr<Mesh> mesh;
+        std::unique_ptr<Vertex> origin;
+        crps::raw_ptr<Vertex> selected;
+
+        template <class Archive>
+        void serialize(Archive& ar) { ar(crps::in_place(mesh), crps::in_place(origin), selected); }
+    };
+}
+
+using crps_test::Scene;
+
+int main()
+{
+    Scene scene{};
+    scene.mesh = std::make_shared<Mesh>();
+    scene.mesh->build(50);
+    scene.origin.reset(new Vertex{ 7, 1.5f });
+    scene.selected = &scene.mesh->vertices[20];
+    const std::string bytes = crps_test::saveCRPS(scene);
+
+    // The first load allocates, the reload keeps every address
+    Scene loaded{};
+    crps_test::loadCRPS(bytes, loaded);
+    CRPS_CHECK(loaded.mesh->matches(50));
+    CRPS_CHECK(loaded.origin->id == 7);
+    CRPS_CHECK(loaded.selected.ptr == &loaded.mesh->vertices[20]);
+
+    Mesh* const mesh_address = loaded.mesh.get();
+    Vertex* const origin_address = loaded.origin.get();
+    Vertex* const vertices_address = loaded.mesh->vertices.data();
+    loaded.mesh->vertices[3].weight = -1.0f;
+    loaded.origin->id = 0;
+    {
+        std::istringstream stream(bytes);
+        cereal::BinaryInputArchive iarchive(stream);
+        crps::CRPSInputArchive<cereal::BinaryInputArchive> crps_iarchive(iarchive);
+        crps_iarchive.setInPlace(true);
+        crps_iarchive(loaded);
+        crps_iarchive.complete();
+    }
+    CRPS_CHECK(loaded.mesh.get() == mesh_address);
+    CRPS_CHECK(loaded.origin.get() == origin_address);
+    CRPS_CHECK(loaded.mesh->vertices.data() == vertices_address);
+    CRPS_CHECK(loaded.mesh->matches(50));
+    CRPS_CHECK(loaded.origin->id == 7);
+    CRPS_CHECK(loaded.selected.ptr == &loaded.mesh->vertices[20]);
+
+    // Enabling in-place loading after pointers were loaded throws
+    {
+        Scene late{};
+        std::istringstream stream(bytes);
+        cereal::BinaryInputArchive iarchive(stream);
+        crps::CRPSInputArchive<cereal::BinaryInputArchive> crps_iarchive(iarchive);
+        crps_iarchive(late);
+        CRPS_CHECK_THROWS(crps_iarchive.setInPlace(true), crps::CRPSException);
+    }
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include "check.hpp"
+#include "graph.hpp"
+
+#include <crps/binary.hpp>
+#include <crps/stream.hpp>
+
+using crps_test::Mesh;
+
+namespace crps_test
+{
+    //! Loads a mesh of count vertices from bytes within limits, through CRPSInputArchive or the native binary archive
+    void loadLimited(std::string const& bytes, crps::CRPSLimits const& limits, bool native, std::size_t count)
+    {
+        std::istringstream stream(bytes);
+        Mesh mesh{};
+        if (native)
+        {
+            crps::BinaryInputArchive iarchive(stream);
+            iarchive.setLimits(limits);
+            iarchive(mesh);
+            iarchive.complete();
+        }
+        else
+        {
+            cereal::BinaryInputArchive iarchive(stream);
+            crps::CRPSInputArchive<cereal::BinaryInputArchive> crps_iarchive(iarchive);
+            crps_iarchive.setLimits(limits);
+            crps_iarchive(mesh);
+            crps_iarchive.complete();
+        }
+        CRPS_CHECK(mesh.matches(count));
+    }
+}
+
+using crps_test::loadLimited;
+
+int main()
+{
+    const std::size_t count = 100;
+    Mesh mesh{};
+    mesh.build(count);
+    const std::string bytes = crps_test::saveCRPS(mesh);
+
+    for (int native = 0; native < 2; native++)
+    {
+        // Loads within the default limits, and throws once a limit is exceeded
+        loadLimited(bytes, crps::CRPSLimits{}, native != 0, count);
+
+        crps::CRPSLimits limits{};
+        limits.max_objects = count / 2;
+        CRPS_CHECK_THROWS(loadLimited(bytes, limits, native != 0, count), crps::CRPSException);
+
+        limits = crps::CRPSLimits{};
+        limits.max_pointers = count;
+        CRPS_CHECK_THROWS(loadLimited(bytes, limits, native != 0, count), crps::CRPSException);
+
+        limits = crps::CRPSLimits{};
+        limits.max_bytes = 64;
+        CRPS_CHECK_THROWS(loadLimited(bytes, limits, native != 0, count), crps::CRPSException);
+
+        // A corrupted table size throws before the table is allocated
+        std::string corrupted = bytes;
+        for (std::size_t i = 0; i < 8; i++) {
+            corrupted[corrupted.size() - 16 + i] = char(0x7f);
+        }
+        CRPS_CHECK_THROWS(loadLimited(corrupted, crps::CRPSLimits{}, native != 0, count), crps::CRPSException);
+    }
+
+    // Saves throw once a limit is exceeded
+    {
+        crps::CRPSLimits limits{};
+        limits.max_objects = count / 2;
+        std::ostringstream stream;
+        cereal::BinaryOutputArchive oarchive(stream);
+        CRPS_CHECK_THROWS(
+            crps::CRPSOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+            crps_oarchive.setLimits(limits);
+            crps_oarchive(mesh),
+            crps::CRPSException);
+
+        std::ostringstream native;
+        CRPS_CHECK_THROWS(
+            crps::BinaryOutputArchive native_oarchive(native);
+            native_oarchive.setLimits(limits);
+            native_oarchive(mesh),
+            crps::CRPSException);
+    }
+
+    // Stream archives apply the limits to each record
+    {
+        std::ostringstream stream;
+        {
+            cereal::BinaryOutputArchive oarchive(stream);
+            crps::CRPSStreamOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+            crps_oarchive(mesh);
+            crps_oarchive(mesh);
+        }
+
+        crps::CRPSLimits limits{};
+        limits.max_pointers = 3 * count;
+        std::istringstream input(stream.str());
+        cereal::BinaryInputArchive iarchive(input);
+        crps::CRPSStreamInputArchive<cereal::BinaryInputArchive> crps_iarchive(iarchive);
+        crps_iarchive.setLimits(limits);
+        Mesh first{};
+        Mesh second{};
+        CRPS_CHECK(crps_iarchive.next(first));
+        CRPS_CHECK(crps_iarchive.next(second));
+        CRPS_CHECK(first.matches(count) && second.matches(count));
+    }
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include "check.hpp"
+#include "graph.hpp"
+
+#include <cereal/archives/json.hpp>
+#include <crps/pipeline.hpp>
+
+#include <stdexcept>
+
+using crps_test::Mesh;
+
+namespace crps_test
+{
+    //! A stream buffer that fails every write
+    class FailingBuffer : public std::streambuf
+    {
+    protected:
+        int_type overflow(int_type) override
+        {
+            return traits_type::eof();
+        }
+
+        std::streamsize xsputn(const char*, std::streamsize) override
+        {
+            return 0;
+        }
+    };
+
+    //! Saves mesh through a CRPSPipelinedOutputArchive with buffers of buffer_size bytes
+    std::string savePipelined(Mesh const& mesh, std::size_t buffer_size, std::size_t buffer_count, bool concurrent)
+    {
+        std::ostringstream stream;
+        crps::CRPSPipelinedOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(stream, buffer_size, buffer_count);
+        crps_oarchive.archive().setConcurrentMapper(concurrent);
+        crps_oarchive(mesh);
+        crps_oarchive.complete();
+        return stream.str();
+    }
+}
+
+using crps_test::savePipelined;
+
+int main()
+{
+    Mesh mesh{};
+    mesh.build(20000);
+    const std::string bytes = crps_test::saveCRPS(mesh);
+
+    // The pipelined output equals the output of CRPSOutputArchive, whatever the buffers
+    for (std::size_t buffer_size : { std::size_t(1), std::size_t(7), std::size_t(4096), std::size_t(1) << 20 })
+    {
+        CRPS_CHECK(savePipelined(mesh, buffer_size, 2, false) == bytes);
+        CRPS_CHECK(savePipelined(mesh, buffer_size, 3, true) == bytes);
+    }
+    Mesh loaded{};
+    crps_test::loadCRPS(savePipelined(mesh, 100, 2, false), loaded);
+    CRPS_CHECK(loaded.matches(20000));
+
+    // Destroying the archive completes the save, and closes archives that write on destruction
+    {
+        std::ostringstream direct;
+        {
+            cereal::JSONOutputArchive oarchive(direct);
+            crps::CRPSOutputArchive<cereal::JSONOutputArchive> crps_oarchive(oarchive);
+            crps_oarchive(mesh);
+        }
+        std::ostringstream pipelined;
+        {
+            crps::CRPSPipelinedOutputArchive<cereal::JSONOutputArchive> crps_oarchive(pipelined, 64);
+            crps_oarchive(mesh);
+        }
+        CRPS_CHECK(pipelined.str() == direct.str());
+    }
+
+    // A failing sink fails the save, and the archive rejects later serializations
+    {
+        crps_test::FailingBuffer failing{};
+        std::ostream sink(&failing);
+        crps::CRPSPipelinedOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(sink, 64);
+        CRPS_CHECK_THROWS(crps_oarchive(mesh); crps_oarchive.complete(), std::exception);
+        CRPS_CHECK_THROWS(crps_oarchive(mesh), crps::CRPSException);
+    }
+
+    // A sink failing only on the last buffer is reported by complete
+    {
+        crps_test::FailingBuffer failing{};
+        std::ostream sink(&failing);
+        crps::CRPSPipelinedOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(sink);
+        crps_oarchive(mesh.vertices[0]);
+        CRPS_CHECK_THROWS(crps_oarchive.complete(), crps::CRPSException);
+    }
+    return 0;
+}
@@ -0,0 +1,160 @@
+#include "check.hpp"
+#include "graph.hpp"
+
+#include <crps/binary.hpp>
+
+#include <map>
+
+namespace crps_test
+{
+    //! A binary tree node, owning its children and pointing at its parent and into another node
+    struct TreeNode
+    {
+        std::uint32_t value{};
+        std::vector<double> padding{};
+        crps::placed_ptr<TreeNode> left{};
+        crps::placed_ptr<TreeNode> right{};
+        crps::raw_ptr<TreeNode> parent{};
+        crps::raw_ptr<std::uint32_t> cross{};
+
+        template <class Archive>
+        void serialize(Archive& ar) { ar(value, padding, crps::placed(left), crps::placed(right), parent, cross, crps::this_ptr(this)); }
+    };
+
+    //! A tree, with pointers into it that are not owned by a node
+    struct Tree
+    {
+        crps::placed_ptr<TreeNode> root{};
+        std::vector<crps::raw_ptr<TreeNode>> index{};
+
+        template <class Archive>
+        void serialize(Archive& ar) { ar(crps::placed(root), index); }
+    };
+
+    //! Creates a full tree of the given depth below parent, numbering nodes in depth-first order
+    TreeNode* buildTree(std::uint32_t& counter, int depth, TreeNode* parent, std::vector<TreeNode*>& nodes)
+    {
+        TreeNode* node = new TreeNode{};
+        node->value = counter++;
+        node->parent = parent;
+        node->padding.assign(node->value % 3, 1.0);
+        nodes.push_back(node);
+        if (depth > 0)
+        {
+            node->left.reset(buildTree(counter, depth - 1, node, nodes));
+            node->right.reset(buildTree(counter, depth - 1, node, nodes));
+        }
+        return node;
+    }
+
+    //! Collects the nodes below node in depth-first order
+    void collect(TreeNode* node, std::vector<TreeNode*>& nodes)
+    {
+        if (node == nullptr) {
+            return;
+        }
+        nodes.push_back(node);
+        collect(node->left.get(), nodes);
+        collect(node->right.get(), nodes);
+    }
+
+    //! True if tree has the count nodes and pointers of the built tree, in arena if it is set
+    bool matchesTree(Tree const& tree, std::uint32_t count, crps::PlacementArena const* arena)
+    {
+        std::vector<TreeNode*> nodes{};
+        collect(tree.root.get(), nodes);
+        if (nodes.size() != count) {
+            return false;
+        }
+        std::map<std::uint32_t, TreeNode*> by_value{};
+        for (TreeNode* node : nodes) {
+            by_value[node->value] = node;
+        }
+        for (TreeNode* node : nodes)
+        {
+            if (node->left && (node->left->parent.ptr != node || node->right->parent.ptr != node)) {
+                return false;
+            }
+            if (node->cross.ptr != &by_value[(node->value * 7 + 3) % count]->value) {
+                return false;
+            }
+            if ((arena != nullptr && arena->contains(node)) != (arena != nullptr)) {
+                return false;
+            }
+        }
+        for (std::size_t i = 0; i < tree.index.size(); i++)
+        {
+            if (tree.index[i].ptr != by_value[static_cast<std::uint32_t>(i * 5 % count)]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //! Loads tree from bytes, placing the nodes into arena in order
+    void loadPlaced(std::string const& bytes, Tree& tree, crps::PlacementArena& arena, crps::PlacementOrder order)
+    {
+        std::istringstream stream(bytes);
+        cereal::BinaryInputArchive iarchive(stream);
+        crps::CRPSInputArchive<cereal::BinaryInputArchive> crps_iarchive(iarchive);
+        crps_iarchive.setPlacement(arena, order);
+        crps_iarchive(tree);
+        crps_iarchive.complete();
+    }
+}
+
+using crps_test::Tree;
+using crps_test::TreeNode;
+
+int main()
+{
+    Tree tree{};
+    std::uint32_t count = 0;
+    std::vector<TreeNode*> nodes{};
+    tree.root.reset(crps_test::buildTree(count, 9, nullptr, nodes));
+    for (TreeNode* node : nodes) {
+        node->cross = &nodes[(node->value * 7 + 3) % count]->value;
+    }
+    for (std::size_t i = 0; i < 100; i++) {
+        tree.index.push_back(nodes[i * 5 % count]);
+    }
+    CRPS_CHECK(crps_test::matchesTree(tree, count, nullptr));
+    const std::string bytes = crps_test::saveCRPS(tree);
+
+    // Nodes are placed next to their parent, in breadth-first or traversal order
+    for (crps::PlacementOrder order : { crps::PlacementOrder::Traversal, crps::PlacementOrder::BreadthFirst })
+    {
+        crps::PlacementArena arena(4096);
+        Tree loaded{};
+        crps_test::loadPlaced(bytes, loaded, arena, order);
+        CRPS_CHECK(crps_test::matchesTree(loaded, count, &arena));
+        CRPS_CHECK(arena.size() == count * sizeof(TreeNode));
+
+        const char* root = reinterpret_cast<const char*>(loaded.root.get());
+        const char* left = reinterpret_cast<const char*>(loaded.root->left.get());
+        const char* right = reinterpret_cast<const char*>(loaded.root->right.get());
+        CRPS_CHECK(left == root + sizeof(TreeNode) || (order == crps::PlacementOrder::BreadthFirst && right == root + sizeof(TreeNode)));
+    }
+
+    // Ownership is found among many blocks, and objects reset outside of the arena are deleted
+    {
+        crps::PlacementArena arena(1);
+        Tree loaded{};
+        crps_test::loadPlaced(bytes, loaded, arena, crps::PlacementOrder::BreadthFirst);
+        CRPS_CHECK(crps_test::matchesTree(loaded, count, &arena));
+        for (TreeNode* node : nodes) {
+            CRPS_CHECK(!arena.contains(node));
+        }
+        loaded.root->left->left.reset(new TreeNode{});
+        CRPS_CHECK(!arena.contains(loaded.root->left->left.get()));
+    }
+
+    // Without an arena the nodes stay where they were loaded
+    {
+        Tree loaded{};
+        crps_test::loadCRPS(bytes, loaded);
+        CRPS_CHECK(crps_test::matchesTree(loaded, count, nullptr));
+        CRPS_CHECK(!loaded.root.get_deleter().arena);
+    }
+    return 0;
+}
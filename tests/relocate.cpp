@@ -0,0 +1,56 @@
+#include "check.hpp"
+#include "graph.hpp"
+
+using crps_test::Mesh;
+using crps_test::Vertex;
+using crps_test::Edge;
+
+int main()
+{
+    Mesh mesh{};
+    mesh.build(300);
+    const std::string bytes = crps_test::saveCRPS(mesh);
+
+    Mesh loaded{};
+    std::istringstream stream(bytes);
+    cereal::BinaryInputArchive iarchive(stream);
+    crps::CRPSInputArchive<cereal::BinaryInputArchive> crps_iarchive(iarchive);
+    crps_iarchive.setRetainTables(true);
+    crps_iarchive(loaded);
+    crps_iarchive.complete();
+    CRPS_CHECK(loaded.matches(300));
+
+    // Move the vertices, which the edges point into
+    {
+        std::vector<Vertex> moved(loaded.vertices.begin(), loaded.vertices.end());
+        const void* old_base = loaded.vertices.data();
+        crps_iarchive.relocate(old_base, moved.data(), loaded.vertices.size() * sizeof(Vertex));
+        loaded.vertices.swap(moved);
+    }
+    CRPS_CHECK(loaded.matches(300));
+
+    // Move the edges, then the vertices again, so both pointers and targets were relocated
+    {
+        std::vector<Edge> moved(loaded.edges.begin(), loaded.edges.end());
+        const void* old_base = loaded.edges.data();
+        crps_iarchive.relocate(old_base, moved.data(), loaded.edges.size() * sizeof(Edge));
+        loaded.edges.swap(moved);
+    }
+    {
+        std::vector<Vertex> moved(loaded.vertices.begin(), loaded.vertices.end());
+        const void* old_base = loaded.vertices.data();
+        crps_iarchive.relocate(old_base, moved.data(), loaded.vertices.size() * sizeof(Vertex));
+        loaded.vertices.swap(moved);
+    }
+    CRPS_CHECK(loaded.matches(300));
+
+    // Relocation without retained tables throws
+    Mesh unretained{};
+    std::istringstream unretained_stream(bytes);
+    cereal::BinaryInputArchive unretained_iarchive(unretained_stream);
+    crps::CRPSInputArchive<cereal::BinaryInputArchive> unretained_crps_iarchive(unretained_iarchive);
+    unretained_crps_iarchive(unretained);
+    unretained_crps_iarchive.complete();
+    CRPS_CHECK_THROWS(unretained_crps_iarchive.relocate(unretained.vertices.data(), unretained.vertices.data(), 1), crps::CRPSException);
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include "check.hpp"
+#include "graph.hpp"
+
+#include <cereal/types/memory.hpp>
+
+#include <memory>
+
+using crps_test::Mesh;
+using crps_test::Vertex;
+
+namespace crps_test
+{
+    //! Elements further apart than the longest stride of a run
+    struct Padded
+    {
+        Vertex vertex;
+        char padding[8192];
+
+        template <class Archive>
+        void serialize(Archive& ar) { ar(vertex); }
+    };
+
+    //! Pointers to padded vertices and to vertices owned by std::shared_ptr
+    struct Links
+    {
+        std::vector<crps::raw_ptr<Vertex>> vertices;
+
+        template <class Archive>
+        void serialize(Archive& ar) { ar(vertices); }
+    };
+}
+
+using crps_test::Padded;
+using crps_test::Links;
+
+//! Saves args, returning the statistics of the save
+template <class ... Types>
+crps::CRPSMapperStats saveStats(std::string& bytes, Types const& ... args)
+{
+    std::ostringstream stream;
+    crps::CRPSMapperStats stats{};
+    {
+        cereal::BinaryOutputArchive oarchive(stream);
+        crps::CRPSOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+        crps_oarchive(args...);
+        crps_oarchive.complete();
+        stats = crps_oarchive.stats();
+    }
+    bytes = stream.str();
+    return stats;
+}
+
+int main()
+{
+    std::string bytes{};
+
+    // The vertices and edges of a mesh are two runs, instead of one index entry per object
+    Mesh mesh{};
+    mesh.build(5000);
+    crps::CRPSMapperStats stats = saveStats(bytes, mesh);
+    CRPS_CHECK(stats.address_runs >= 2);
+    CRPS_CHECK(stats.table_entries < 100);
+    Mesh loaded{};
+    crps_test::loadCRPS(bytes, loaded);
+    CRPS_CHECK(loaded.matches(5000));
+
+    // Elements with a large stride are indexed one by one
+    std::vector<Padded> padded(64);
+    Links links{};
+    for (std::size_t i = 0; i < padded.size(); i++) {
+        padded[i].vertex = Vertex{ static_cast<std::uint32_t>(i), 0.0f };
+        links.vertices.push_back(&padded[(i * 5) % padded.size()].vertex);
+    }
+    stats = saveStats(bytes, padded, links);
+    CRPS_CHECK(stats.table_entries >= padded.size());
+    std::vector<Padded> loaded_padded{};
+    Links loaded_links{};
+    crps_test::loadCRPS(bytes, loaded_padded, loaded_links);
+    for (std::size_t i = 0; i < padded.size(); i++) {
+        CRPS_CHECK(loaded_links.vertices[i].ptr == &loaded_padded[(i * 5) % padded.size()].vertex);
+    }
+
+    // Objects owned by std::shared_ptr alternate with their pointers, and form no stored runs
+    std::vector<std::shared_ptr<Vertex>> shared{};
+    Links shared_links{};
+    for (std::uint32_t i = 0; i < 1000; i++) {
+        shared.push_back(std::make_shared<Vertex>(Vertex{ i, 1.0f }));
+    }
+    for (std::size_t i = 0; i < shared.size(); i++) {
+        shared_links.vertices.push_back(shared[(i * 7) % shared.size()].get());
+    }
+    stats = saveStats(bytes, shared, shared_links);
+    CRPS_CHECK(stats.address_runs <= 2);
+    std::vector<std::shared_ptr<Vertex>> loaded_shared{};
+    Links loaded_shared_links{};
+    crps_test::loadCRPS(bytes, loaded_shared, loaded_shared_links);
+    for (std::size_t i = 0; i < shared.size(); i++) {
+        CRPS_CHECK(loaded_shared_links.vertices[i].ptr == loaded_shared[(i * 7) % shared.size()].get());
+    }
+
+    // A run saved twice overlaps its stored run, and pointers resolve to the latest objects
+    Mesh twice{};
+    twice.build(100);
+    saveStats(bytes, twice.vertices, twice.vertices, twice.edges);
+    std::vector<Vertex> first{};
+    Mesh second{};
+    crps_test::loadCRPS(bytes, first, second.vertices, second.edges);
+    CRPS_CHECK(second.matches(100));
+    return 0;
+}
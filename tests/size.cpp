@@ -0,0 +1,24 @@
+#include "check.hpp"
+#include "graph.hpp"
+
+#include <crps/size.hpp>
+
+using crps_test::Mesh;
+
+int main()
+{
+    for (std::size_t count : { 0, 1, 100, 5000 })
+    {
+        Mesh mesh{};
+        mesh.build(count);
+
+        const std::uint64_t expected = crps::output_size<cereal::BinaryOutputArchive>(mesh);
+        const std::string bytes = crps_test::saveCRPS(mesh);
+        CRPS_CHECK(expected == bytes.size());
+
+        Mesh loaded{};
+        crps_test::loadCRPS(bytes, loaded);
+        CRPS_CHECK(loaded.matches(count));
+    }
+    return 0;
+}
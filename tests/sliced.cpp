@@ -0,0 +1,62 @@
+#include "check.hpp"
+#include "graph.hpp"
+
+#include <crps/sliced.hpp>
+
+using crps_test::Mesh;
+
+int main()
+{
+    Mesh mesh{};
+    mesh.build(20000);
+    std::uint32_t header = 7;
+    const std::string plain = crps_test::saveCRPS(header, mesh.vertices, mesh.edges);
+
+    // Short steps produce the output of a plain save
+    std::size_t steps = 0;
+    std::ostringstream sliced_stream;
+    {
+        cereal::BinaryOutputArchive oarchive(sliced_stream);
+        crps::CRPSOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+        crps::SlicedSave<cereal::BinaryOutputArchive> sliced(crps_oarchive);
+        sliced(header).elements(mesh.vertices).elements(mesh.edges);
+        while (!sliced.step(std::chrono::microseconds(50))) {
+            steps++;
+        }
+        CRPS_CHECK(sliced.done());
+        CRPS_CHECK(sliced.step(std::chrono::microseconds(50)));
+    }
+    CRPS_CHECK(steps > 0);
+    CRPS_CHECK(sliced_stream.str() == plain);
+
+    Mesh loaded{};
+    std::uint32_t loaded_header = 0;
+    crps_test::loadCRPS(sliced_stream.str(), loaded_header, loaded.vertices, loaded.edges);
+    CRPS_CHECK(loaded_header == 7);
+    CRPS_CHECK(loaded.matches(20000));
+
+    // complete_async during the sliced book-keeping continues the remaining steps
+    std::ostringstream async_stream;
+    {
+        cereal::BinaryOutputArchive oarchive(async_stream);
+        crps::CRPSOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+        crps_oarchive(header, mesh.vertices, mesh.edges);
+        crps_oarchive.complete_step(std::chrono::steady_clock::now());
+        crps_oarchive.complete_async().get();
+    }
+    CRPS_CHECK(async_stream.str() == plain);
+
+    // An interrupted sliced save is finished by complete
+    std::ostringstream interrupted_stream;
+    {
+        cereal::BinaryOutputArchive oarchive(interrupted_stream);
+        crps::CRPSOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+        crps::SlicedSave<cereal::BinaryOutputArchive> sliced(crps_oarchive);
+        sliced(header, mesh.vertices, mesh.edges);
+        sliced.step(std::chrono::nanoseconds(0));
+        crps_oarchive.complete_step(std::chrono::steady_clock::now());
+        crps_oarchive.complete();
+    }
+    CRPS_CHECK(interrupted_stream.str() == plain);
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include "check.hpp"
+#include "graph.hpp"
+
+#include <crps/binary.hpp>
+
+using crps_test::Mesh;
+
+int main()
+{
+    // Runs are merged in levels, so few runs remain and every entry is read back in order
+    {
+        crps::detail::SpillRuns runs{};
+        runs.setCapacity(64);
+        const std::size_t count = 64 * 16 * 16 * 3 + 17;
+        std::uint64_t state = 1;
+        for (std::size_t i = 0; i < count; i++)
+        {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            runs.push(static_cast<std::uintptr_t>(state >> 16), static_cast<std::uint32_t>(i));
+        }
+        runs.spill();
+        CRPS_CHECK(runs.spilledRuns().size() <= 4);
+
+        crps::detail::SpillMerge merge(runs);
+        crps::detail::SpillEntry entry{};
+        crps::detail::SpillEntry previous{ 0, 0 };
+        std::size_t read = 0;
+        while (merge.next(entry))
+        {
+            CRPS_CHECK(read == 0 || !(entry < previous));
+            previous = entry;
+            read++;
+        }
+        CRPS_CHECK(read == count);
+    }
+
+    // A small spill budget forces several merge cycles, and matches a save without spilling
+    Mesh mesh{};
+    mesh.build(20000);
+    const std::string plain = crps_test::saveCRPS(mesh);
+
+    std::ostringstream spilled;
+    {
+        cereal::BinaryOutputArchive oarchive(spilled);
+        crps::CRPSOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+        crps_oarchive.setSpillBudget(64 * sizeof(crps::detail::SpillEntry));
+        crps_oarchive(mesh);
+        crps_oarchive.complete();
+        CRPS_CHECK(crps_oarchive.stats().spilled);
+    }
+    CRPS_CHECK(spilled.str() == plain);
+
+    std::ostringstream native;
+    {
+        crps::BinaryOutputArchive oarchive(native);
+        oarchive.setSpillBudget(64 * sizeof(crps::detail::SpillEntry));
+        oarchive(mesh);
+    }
+    CRPS_CHECK(native.str() == plain);
+
+    Mesh loaded{};
+    crps_test::loadCRPS(spilled.str(), loaded);
+    CRPS_CHECK(loaded.matches(20000));
+    return 0;
+}
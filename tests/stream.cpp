@@ -0,0 +1,178 @@
+#include "check.hpp"
+#include "graph.hpp"
+
+#include <cereal/types/memory.hpp>
+#include <crps/stream.hpp>
+
+#include <deque>
+#include <memory>
+
+using crps_test::Vertex;
+
+namespace crps_test
+{
+    //! A record sharing its vertex with other records, with pointers into the vertex and into itself
+    struct Event
+    {
+        std::shared_ptr<Vertex> vertex;
+        std::vector<Vertex> samples;
+        crps::raw_ptr<float> weight;
+        crps::raw_ptr<Vertex> sample;
+
+        template <class Archive>
+        void serialize(Archive& ar) { ar(vertex, samples, weight, sample); }
+    };
+
+    //! A record pointing at a sample of an earlier record, with the samples tracked as one range
+    struct Trace
+    {
+        std::vector<Vertex> samples;
+        crps::raw_ptr<Vertex> earlier;
+
+        template <class Archive>
+        void serialize(Archive& ar) { ar(crps::blit(samples), earlier); }
+    };
+
+    //! A record that defers its samples, which stream archives reject
+    struct DeferredEvent
+    {
+        std::vector<Vertex> samples;
+
+        template <class Archive>
+        void serialize(Archive& ar) { ar(cereal::defer(samples)); }
+    };
+}
+
+using crps_test::Event;
+using crps_test::Trace;
+using crps_test::DeferredEvent;
+
+//! Loads the traces of bytes into loaded, with the window and limits, until the end of the stream
+void loadTraces(std::string const& bytes, std::size_t window, crps::CRPSLimits const& limits, std::deque<Trace>& loaded)
+{
+    std::istringstream input(bytes);
+    cereal::BinaryInputArchive iarchive(input);
+    crps::CRPSStreamInputArchive<cereal::BinaryInputArchive> crps_iarchive(iarchive);
+    crps_iarchive.setWindow(window);
+    crps_iarchive.setLimits(limits);
+    loaded.resize(1);
+    while (crps_iarchive.next(loaded.back())) {
+        loaded.emplace_back();
+    }
+    loaded.pop_back();
+}
+
+int main()
+{
+    const std::size_t count = 2000;
+    std::vector<std::shared_ptr<Vertex>> vertices{};
+    for (std::size_t i = 0; i < 10; i++) {
+        vertices.push_back(std::make_shared<Vertex>(Vertex{ static_cast<std::uint32_t>(i), static_cast<float>(i) }));
+    }
+    std::vector<Event> events(count);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        Event& event = events[i];
+        event.vertex = vertices[i % vertices.size()];
+        event.samples = { Vertex{ static_cast<std::uint32_t>(i), 0.0f }, Vertex{ static_cast<std::uint32_t>(i + 1), 1.0f } };
+        event.weight = &event.vertex->weight;
+        event.sample = &event.samples[i % 2];
+    }
+
+    // The book-keeping of each record holds only its own pointers
+    std::ostringstream stream;
+    {
+        cereal::BinaryOutputArchive oarchive(stream);
+        crps::CRPSStreamOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+        for (Event& event : events)
+        {
+            crps_oarchive(event);
+            CRPS_CHECK(crps_oarchive.stats().pointers == 2);
+        }
+    }
+
+    std::istringstream input(stream.str());
+    cereal::BinaryInputArchive iarchive(input);
+    crps::CRPSStreamInputArchive<cereal::BinaryInputArchive> crps_iarchive(iarchive);
+    std::deque<Event> loaded(1);
+    while (crps_iarchive.next(loaded.back()))
+    {
+        Event const& event = loaded.back();
+        const std::size_t i = loaded.size() - 1;
+        CRPS_CHECK(event.vertex->id == i % vertices.size());
+        CRPS_CHECK(event.weight.ptr == &event.vertex->weight);
+        CRPS_CHECK(event.sample.ptr == &event.samples[i % 2]);
+        CRPS_CHECK(event.samples[1].id == i + 1);
+        loaded.emplace_back();
+    }
+    CRPS_CHECK(loaded.size() == count + 1);
+    CRPS_CHECK(crps_iarchive.done());
+    CRPS_CHECK(loaded[0].vertex == loaded[vertices.size()].vertex);
+
+    // Pointers from record i into record i - 3 stay valid within a window of 3 records, 
+    // and the objects of older records are released, so they do not count toward the limits
+    const std::size_t distance = 3;
+    crps::CRPSLimits window_limits{};
+    window_limits.max_objects = 100;
+    std::vector<Trace> traces(500);
+    for (std::size_t i = 0; i < traces.size(); i++)
+    {
+        traces[i].samples = { Vertex{ static_cast<std::uint32_t>(i), 0.0f }, Vertex{ static_cast<std::uint32_t>(i), 1.0f } };
+        traces[i].earlier = i < distance ? nullptr : &traces[i - distance].samples[i % 2];
+    }
+    std::ostringstream traces_stream;
+    {
+        cereal::BinaryOutputArchive oarchive(traces_stream);
+        crps::CRPSStreamOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+        crps_oarchive.setWindow(distance);
+        crps_oarchive.setLimits(window_limits);
+        for (Trace& trace : traces) {
+            crps_oarchive(trace);
+        }
+        CRPS_CHECK(crps_oarchive.stats().objects > window_limits.max_objects);
+        CRPS_CHECK(crps_oarchive.stats().table_entries < window_limits.max_objects);
+    }
+
+    std::deque<Trace> loaded_traces{};
+    loadTraces(traces_stream.str(), distance, window_limits, loaded_traces);
+    CRPS_CHECK(loaded_traces.size() == traces.size());
+    for (std::size_t i = 0; i < loaded_traces.size(); i++)
+    {
+        CRPS_CHECK(loaded_traces[i].samples[0].id == i);
+        CRPS_CHECK(loaded_traces[i].earlier.ptr == (i < distance ? nullptr : &loaded_traces[i - distance].samples[i % 2]));
+    }
+
+    // Without a window, every earlier record may be referenced
+    std::deque<Trace> unbounded_traces{};
+    loadTraces(traces_stream.str(), 0, crps::CRPSLimits{}, unbounded_traces);
+    CRPS_CHECK(unbounded_traces[distance].earlier.ptr == &unbounded_traces[0].samples[1]);
+    CRPS_CHECK_THROWS(loadTraces(traces_stream.str(), 0, window_limits, unbounded_traces), crps::CRPSException);
+
+    // A load window smaller than the save window throws on the first pointer beyond it
+    {
+        std::deque<Trace> short_traces{};
+        CRPS_CHECK_THROWS(loadTraces(traces_stream.str(), distance - 1, crps::CRPSLimits{}, short_traces), crps::CRPSException);
+    }
+
+    // Pointers to records older than the window throw when saved
+    {
+        std::ostringstream output;
+        cereal::BinaryOutputArchive oarchive(output);
+        crps::CRPSStreamOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+        crps_oarchive.setWindow(distance - 1);
+        for (std::size_t i = 0; i < distance; i++) {
+            crps_oarchive(traces[i]);
+        }
+        CRPS_CHECK_THROWS(crps_oarchive(traces[distance]), crps::CRPSException);
+    }
+
+    // cereal::defer throws instead of being saved again with every later record
+    {
+        std::ostringstream output;
+        cereal::BinaryOutputArchive oarchive(output);
+        crps::CRPSStreamOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+        DeferredEvent deferred{};
+        CRPS_CHECK_THROWS(crps_oarchive(deferred), crps::CRPSException);
+    }
+    return 0;
+}
@@ -0,0 +1,38 @@
+#include "check.hpp"
+#include "graph.hpp"
+
+#include <cereal/archives/json.hpp>
+
+using crps_test::Mesh;
+
+int main()
+{
+    Mesh mesh{};
+    mesh.build(200);
+
+    std::ostringstream binary_stream;
+    std::ostringstream json_stream;
+    {
+        cereal::BinaryOutputArchive binary_archive(binary_stream);
+        cereal::JSONOutputArchive json_archive(json_stream);
+        crps::CRPSOutputArchive<cereal::BinaryOutputArchive, cereal::JSONOutputArchive> crps_oarchive(binary_archive, json_archive);
+        crps_oarchive(mesh);
+    }
+
+    // The binary output is the same as that of a save to the binary archive alone
+    CRPS_CHECK(binary_stream.str() == crps_test::saveCRPS(mesh));
+
+    Mesh from_binary{};
+    crps_test::loadCRPS(binary_stream.str(), from_binary);
+    CRPS_CHECK(from_binary.matches(200));
+
+    Mesh from_json{};
+    {
+        std::istringstream stream(json_stream.str());
+        cereal::JSONInputArchive iarchive(stream);
+        crps::CRPSInputArchive<cereal::JSONInputArchive> crps_iarchive(iarchive);
+        crps_iarchive(from_json);
+    }
+    CRPS_CHECK(from_json.matches(200));
+    return 0;
+}
@@ -0,0 +1,94 @@
+#define CRPS_ENABLE_TRACE
+
+#include "check.hpp"
+#include "graph.hpp"
+
+#include <crps/trace.hpp>
+
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+using crps_test::Mesh;
+
+//! Saves mesh from untraced.cpp, which is compiled without CRPS_ENABLE_TRACE
+std::string saveUntraced(Mesh const& mesh);
+
+namespace crps_test
+{
+    //! Records the names of the phases reported to it
+    class RecordingSink : public crps::CRPSTraceSink
+    {
+    public:
+        void event(crps::CRPSTraceEvent const& event) override
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            names.push_back(event.name);
+            ordered = ordered && !(event.end < event.begin);
+            counted = counted || event.counted;
+        }
+
+        std::vector<std::string> names{};
+        bool ordered{ true };
+        bool counted{ false };
+        std::mutex mutex{};
+    };
+}
+
+int main()
+{
+    Mesh mesh{};
+    mesh.build(200);
+
+    // Events are reported only while a sink is set
+    crps_test::RecordingSink recording{};
+    crps_test::saveCRPS(mesh);
+    crps::set_trace_sink(&recording);
+    const std::string bytes = crps_test::saveCRPS(mesh);
+    crps::set_trace_sink(nullptr);
+    crps_test::saveCRPS(mesh);
+    CRPS_CHECK(recording.names.size() == 5);
+    CRPS_CHECK(recording.ordered && recording.counted);
+
+    // Archives of a translation unit compiled without CRPS_ENABLE_TRACE report nothing, and save the same output
+    crps::set_trace_sink(&recording);
+    CRPS_CHECK(saveUntraced(mesh) == bytes);
+    crps::set_trace_sink(nullptr);
+    CRPS_CHECK(recording.names.size() == 5);
+
+    // The Chrome trace names every phase, with the process id, and leaves the flags of the stream unchanged
+    std::ostringstream trace;
+    trace << std::scientific << std::setprecision(2);
+    {
+        crps::ChromeTraceSink sink(trace);
+        crps::set_trace_sink(&sink);
+        {
+            std::ostringstream stream;
+            cereal::BinaryOutputArchive oarchive(stream);
+            crps::CRPSOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+            crps_oarchive(mesh);
+            crps_oarchive.complete_async().get();
+        }
+        Mesh loaded{};
+        crps_test::loadCRPS(bytes, loaded);
+        CRPS_CHECK(loaded.matches(200));
+        crps::set_trace_sink(nullptr);
+    }
+    CRPS_CHECK((trace.flags() & std::ios::floatfield) == std::ios::scientific && trace.precision() == 2);
+
+    const std::string text = trace.str();
+    for (const char* name : { "user_archive", "mapper", "deferments", "pointer_table", "save_pointer_table", "load_pointer_table", "fixup" }) {
+        CRPS_CHECK(text.find(std::string("\"name\":\"") + name + "\"") != std::string::npos);
+    }
+    CRPS_CHECK(text.find("\"tid\":2") != std::string::npos);
+    CRPS_CHECK(text.find("e+") == std::string::npos);
+#ifndef _WIN32
+    CRPS_CHECK(text.find("\"pid\":" + std::to_string(getpid()) + ",") != std::string::npos);
+#endif
+    CRPS_CHECK(text.front() == '[' && text.substr(text.size() - 3) == "\n]\n");
+    return 0;
+}
@@ -0,0 +1,16 @@
+#include "graph.hpp"
+
+using crps_test::Mesh;
+
+//! Saves mesh through archives without trace hooks, for the trace test
+/*! Defined apart from crps_test::saveCRPS, whose instantiation is shared with trace.cpp. */
+std::string saveUntraced(Mesh const& mesh)
+{
+    std::ostringstream stream;
+    {
+        cereal::BinaryOutputArchive oarchive(stream);
+        crps::CRPSOutputArchive<cereal::BinaryOutputArchive> crps_oarchive(oarchive);
+        crps_oarchive(mesh);
+    }
+    return stream.str();
+}